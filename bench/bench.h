@@ -0,0 +1,31 @@
+/*
+ * Shared declarations of the SB_Buffer microbenchmark suite.
+ */
+#ifndef SB_BENCH_H
+#define SB_BENCH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Results are accumulated here so the compiler cannot drop the work */
+extern volatile size_t bench_sink;
+
+/* std::string baselines (bench_baseline.cpp); return the bytes processed */
+size_t bench_std_string_append(size_t iters, const char *piece, size_t len, size_t clear_at);
+size_t bench_std_string_copy(size_t iters, const char *src, size_t len);
+size_t bench_std_string_pipeline(size_t iters, const char *piece, size_t len);
+size_t bench_std_intern(size_t iters);
+
+/* sb::buffer (sb_buffer.hpp) entries, also in bench_baseline.cpp */
+size_t bench_cpp_buffer_pipeline(size_t iters, const char *piece, size_t len);
+size_t bench_cpp_header_chain(size_t iters);
+size_t bench_cpp_header_append(size_t iters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_BENCH_H */
@@ -0,0 +1,124 @@
+/*
+ * std::string baselines and sb::buffer (C++ wrapper) entries for the
+ * SB_Buffer microbenchmarks.
+ */
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+#include <utility>
+#include <cstddef>
+
+#include "bench.h"
+#include "sb_buffer.hpp"
+
+extern "C" size_t bench_std_string_append(size_t iters, const char *piece, size_t len, size_t clear_at){
+    std::string s;
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iters; i++) {
+        if (s.size() + len > clear_at) s.clear();
+        s.append(piece, len);
+        bytes += len;
+    }
+
+    bench_sink += s.size();
+    return bytes;
+}
+
+extern "C" size_t bench_std_string_copy(size_t iters, const char *src, size_t len){
+    std::string from(src, len);
+    std::string to;
+
+    for (size_t i = 0; i < iters; i++) {
+        to = from;
+        bench_sink += to.size();
+    }
+
+    return iters * len;
+}
+
+/* Builds messages and moves them through two vectors (the growth relocates them too) */
+template <class Str>
+static size_t bench_pipeline(size_t iters, const char *piece, size_t len){
+    std::vector<Str> stage, done;
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iters; i++) {
+        Str s;
+        s.append(piece, len);
+        stage.push_back(std::move(s));
+        bytes += len;
+
+        if (stage.size() == 256) {
+            for (Str &m : stage) done.push_back(std::move(m));
+            bench_sink += done.back().size();
+            stage.clear();
+            done.clear();
+        }
+    }
+
+    return bytes;
+}
+
+extern "C" size_t bench_cpp_buffer_pipeline(size_t iters, const char *piece, size_t len){
+    return bench_pipeline<sb::buffer<64>>(iters, piece, len);
+}
+
+extern "C" size_t bench_std_string_pipeline(size_t iters, const char *piece, size_t len){
+    return bench_pipeline<std::string>(iters, piece, len);
+}
+
+/* Fixed response headers plus a length, as separate appends or one append() */
+extern "C" size_t bench_cpp_header_chain(size_t iters){
+    sb::buffer<256> b;
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iters; i++) {
+        b.clear();
+        b += "HTTP/1.1 200 OK\r\n";
+        b += "Content-Type: text/html; charset=utf-8\r\n";
+        b += "Connection: keep-alive\r\n";
+        b += "Content-Length: ";
+        sb_buffer_add_u64(b.raw(), i & 0xFFFF);
+        b += "\r\n\r\n";
+        bytes += b.size();
+    }
+
+    bench_sink += b.size();
+    return bytes;
+}
+
+extern "C" size_t bench_cpp_header_append(size_t iters){
+    static constexpr auto head = sb::concat("HTTP/1.1 200 OK\r\n",
+                                            "Content-Type: text/html; charset=utf-8\r\n",
+                                            "Connection: keep-alive\r\n",
+                                            "Content-Length: ");
+    sb::buffer<256> b;
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iters; i++) {
+        b.clear();
+        b.append(head, i & 0xFFFF, "\r\n\r\n");
+        bytes += b.size();
+    }
+
+    bench_sink += b.size();
+    return bytes;
+}
+
+/* Interns header-like keys drawn from a set of 4096 (std::unordered_map of std::string) */
+extern "C" size_t bench_std_intern(size_t iters){
+    std::unordered_map<std::string, uint32_t> ids;
+    char key[32];
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < iters; i++) {
+        int n = snprintf(key, sizeof(key), "x-header-%u", (unsigned)((i * 2654435761u) & 4095));
+        auto it = ids.emplace(std::string(key, (size_t)n), (uint32_t)ids.size()).first;
+        bench_sink += it->second;
+        bytes += (size_t)n;
+    }
+
+    return bytes;
+}
@@ -0,0 +1,1090 @@
+/*
+ * SB_Buffer microbenchmark suite.
+ *
+ *   sb_bench [--filter substring] [--scale factor] [--reps n]
+ *
+ * Every benchmark prints one JSON object per line:
+ *   {"bench":"append_tiny","impl":"sb_buffer","iters":...,"ns_per_op":...,"bytes_per_sec":...}
+ * The best of --reps runs is reported, so successive versions can be diffed
+ * to catch regressions.
+ */
+#define _POSIX_C_SOURCE 200809L /* clock_gettime */
+
+#include "sb_buffer.h"
+#include "sb_search.h"
+#include "sb_escape.h"
+#include "sb_codec.h"
+#include "sb_pool.h"
+#include "sb_logbuf.h"
+#include "sb_mmap.h"
+#include "sb_iovec.h"
+#include "sb_uring.h"
+#include "sb_hash.h"
+#include "sb_compare.h"
+#include "sb_huge.h"
+#include "sb_build.h"
+#include "sb_utf8.h"
+#include "bench.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+volatile size_t bench_sink;
+
+/* Source data for the appends (filled with printable bytes) */
+#define BENCH_DATA_SIZE 65536
+static char bench_data[BENCH_DATA_SIZE + 1];
+
+/* Appends restart from an empty buffer past this length */
+#define BENCH_CLEAR_AT 65536
+
+typedef struct {
+    const char *name;           /* Workload */
+    const char *impl;           /* Implementation under test */
+    size_t (*run)(size_t iters);/* Runs iters operations, returns bytes processed */
+    size_t iters;               /* Operations per run (before --scale) */
+} SB_Bench;
+
+/* --- Appends --- */
+
+static size_t bench_sb_append(size_t iters, size_t len, size_t clear_at){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        if (b.len + len > clear_at) sb_buffer_clear(&b);
+        sb_buffer_add_lstring(&b, bench_data, len);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * len;
+}
+
+static size_t bench_sb_append_fast(size_t iters, size_t len, size_t clear_at){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        if (b.len + len > clear_at) sb_buffer_clear(&b);
+        sb_buffer_add_lstring_fast(&b, bench_data, len);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * len;
+}
+
+static size_t bench_memcpy_append(size_t iters, size_t len, size_t clear_at){
+    char *dst = (char*)malloc(clear_at + 1);
+    size_t used = 0;
+    size_t i;
+
+    if (!dst) return 0;
+
+    for (i = 0; i < iters; i++) {
+        if (used + len > clear_at) used = 0;
+        memcpy(dst + used, bench_data, len);
+        used += len;
+        dst[used] = '\0';
+    }
+
+    bench_sink += used + (size_t)dst[0];
+    free(dst);
+    return iters * len;
+}
+
+static size_t bench_strcat_append(size_t iters, size_t len, size_t clear_at){
+    char *dst = (char*)malloc(clear_at + 1);
+    char piece[1024];
+    size_t used = 0;
+    size_t i;
+
+    if (!dst || len >= sizeof(piece)) { free(dst); return 0; }
+
+    memcpy(piece, bench_data, len);
+    piece[len] = '\0';
+    dst[0] = '\0';
+
+    for (i = 0; i < iters; i++) {
+        if (used + len > clear_at) { dst[0] = '\0'; used = 0; }
+        strcat(dst, piece);
+        used += len;
+    }
+
+    bench_sink += strlen(dst);
+    free(dst);
+    return iters * len;
+}
+
+#define BENCH_APPEND_SET(size_name, len, clear_at) \
+    static size_t bench_##size_name##_sb(size_t n) { return bench_sb_append(n, len, clear_at); } \
+    static size_t bench_##size_name##_fast(size_t n) { return bench_sb_append_fast(n, len, clear_at); } \
+    static size_t bench_##size_name##_memcpy(size_t n) { return bench_memcpy_append(n, len, clear_at); } \
+    static size_t bench_##size_name##_std(size_t n) { return bench_std_string_append(n, bench_data, len, clear_at); }
+
+BENCH_APPEND_SET(tiny, 8, BENCH_CLEAR_AT)
+BENCH_APPEND_SET(medium, 128, BENCH_CLEAR_AT)
+BENCH_APPEND_SET(huge, 65536, 16 * 65536)
+
+/* strcat rescans the whole string: keep it short to stay measurable */
+static size_t bench_tiny_strcat(size_t n) { return bench_strcat_append(n, 8, 4096); }
+static size_t bench_medium_strcat(size_t n) { return bench_strcat_append(n, 128, 4096); }
+
+/* --- SSO boundary --- */
+
+/* Builds a fresh buffer of total bytes in two appends, then finalizes it */
+static size_t bench_sso(size_t iters, size_t first, size_t second){
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        SB_Buffer SB_INIT(b);
+        sb_buffer_add_lstring(&b, bench_data, first);
+        sb_buffer_add_lstring(&b, bench_data, second);
+        bench_sink += b.len;
+        sb_buffer_finalize(&b);
+    }
+
+    return iters * (first + second);
+}
+
+/* 244 + 11 = 255 bytes: stays inline (the terminator takes the last byte) */
+static size_t bench_sso_below(size_t n) { return bench_sso(n, 244, SB_BUFFER_INITIAL_CAP - 245); }
+/* 244 + 12 = 256 bytes: migrates to the heap */
+static size_t bench_sso_cross(size_t n) { return bench_sso(n, 244, SB_BUFFER_INITIAL_CAP - 244); }
+
+/* --- Reuse: clear vs reset --- */
+
+static size_t bench_reuse(size_t iters, int hard){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        if (hard) sb_buffer_reset(&b);
+        else sb_buffer_clear(&b);
+        sb_buffer_add_lstring(&b, bench_data, 1024);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 1024;
+}
+
+static size_t bench_reuse_clear(size_t n) { return bench_reuse(n, 0); }
+static size_t bench_reuse_reset(size_t n) { return bench_reuse(n, 1); }
+
+/* --- Copy --- */
+
+static size_t bench_sb_copy(size_t iters, size_t len){
+    SB_Buffer SB_INIT(src);
+    SB_Buffer SB_INIT(dest);
+    size_t i;
+
+    sb_buffer_add_lstring(&src, bench_data, len);
+
+    for (i = 0; i < iters; i++) {
+        sb_buffer_copy(&src, &dest);
+        bench_sink += dest.len;
+    }
+
+    sb_buffer_finalize(&src);
+    sb_buffer_finalize(&dest);
+    return iters * len;
+}
+
+static size_t bench_memcpy_copy(size_t iters, size_t len){
+    char *dst = (char*)malloc(len + 1);
+    size_t i;
+
+    if (!dst) return 0;
+
+    for (i = 0; i < iters; i++) {
+        memcpy(dst, bench_data, len);
+        dst[len] = '\0';
+        bench_sink += (size_t)dst[i % len];
+    }
+
+    free(dst);
+    return iters * len;
+}
+
+static size_t bench_copy_small_sb(size_t n) { return bench_sb_copy(n, 100); }
+static size_t bench_copy_small_memcpy(size_t n) { return bench_memcpy_copy(n, 100); }
+static size_t bench_copy_small_std(size_t n) { return bench_std_string_copy(n, bench_data, 100); }
+static size_t bench_copy_large_sb(size_t n) { return bench_sb_copy(n, 4096); }
+static size_t bench_copy_large_memcpy(size_t n) { return bench_memcpy_copy(n, 4096); }
+static size_t bench_copy_large_std(size_t n) { return bench_std_string_copy(n, bench_data, 4096); }
+
+/* Hands a heap-backed buffer back and forth between two owners */
+static size_t bench_move_heap(size_t iters){
+    SB_Buffer SB_INIT(a);
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    sb_buffer_add_lstring(&a, bench_data, 4096);
+
+    for (i = 0; i < iters; i++) {
+        if (i & 1) sb_buffer_move(&b, &a);
+        else sb_buffer_move(&a, &b);
+        bench_sink += a.len + b.len;
+    }
+
+    sb_buffer_finalize(&a);
+    sb_buffer_finalize(&b);
+    return iters * 4096;
+}
+
+/* Messages of 200 bytes moved through two std::vector stages (C++ wrapper) */
+static size_t bench_pipeline_cpp(size_t n) { return bench_cpp_buffer_pipeline(n, bench_data, 200); }
+static size_t bench_pipeline_std(size_t n) { return bench_std_string_pipeline(n, bench_data, 200); }
+
+/* --- Search --- */
+
+/* 64 KiB haystack of lowercase text ending with "HTTP/1.1\r\n" */
+#define BENCH_HAY_SIZE 65536
+static char bench_hay[BENCH_HAY_SIZE + 1];
+static SB_Buffer bench_hay_buf;
+
+static void bench_hay_setup(void){
+    static const char tail[] = "HTTP/1.1\r\n";
+    size_t i;
+
+    for (i = 0; i < BENCH_HAY_SIZE; i++) bench_hay[i] = (char)('a' + (i * 7) % 26);
+    memcpy(bench_hay + BENCH_HAY_SIZE - (sizeof(tail) - 1), tail, sizeof(tail) - 1);
+    bench_hay[BENCH_HAY_SIZE] = '\0';
+
+    sb_buffer_init(&bench_hay_buf);
+    sb_buffer_add_lstring(&bench_hay_buf, bench_hay, BENCH_HAY_SIZE);
+}
+
+/* Runs fn with the given kernel family forced, then restores the automatic choice */
+#define BENCH_WITH_KERNEL(kernel, expr) \
+    do { if (kernel) sb_search_set_kernel(kernel); expr; if (kernel) sb_search_set_kernel(NULL); } while (0)
+
+static size_t bench_find_char_run(size_t iters, const char *kernel){
+    size_t i;
+    BENCH_WITH_KERNEL(kernel, for (i = 0; i < iters; i++) bench_sink += sb_buffer_find_char(&bench_hay_buf, 0, '\r'));
+    return iters * BENCH_HAY_SIZE;
+}
+
+static size_t bench_find_run(size_t iters, const char *kernel){
+    size_t i;
+    BENCH_WITH_KERNEL(kernel, for (i = 0; i < iters; i++) bench_sink += sb_buffer_find(&bench_hay_buf, 0, "HTTP/1.1", 8));
+    return iters * BENCH_HAY_SIZE;
+}
+
+/* Needle whose prefix repeats every 26 bytes: defeats first-byte prefilters */
+static size_t bench_find_common_run(size_t iters, const char *kernel){
+    size_t i;
+    BENCH_WITH_KERNEL(kernel, for (i = 0; i < iters; i++) bench_sink += sb_buffer_find(&bench_hay_buf, 0, "ahov\r\n", 6));
+    return iters * BENCH_HAY_SIZE;
+}
+
+static size_t bench_find_any_run(size_t iters, const char *kernel){
+    size_t i;
+    BENCH_WITH_KERNEL(kernel, for (i = 0; i < iters; i++) bench_sink += sb_buffer_find_any(&bench_hay_buf, 0, "\r\n\"<>&"));
+    return iters * BENCH_HAY_SIZE;
+}
+
+static size_t bench_count_run(size_t iters, const char *kernel){
+    size_t i;
+    BENCH_WITH_KERNEL(kernel, for (i = 0; i < iters; i++) bench_sink += sb_buffer_count_char(&bench_hay_buf, 'e'));
+    return iters * BENCH_HAY_SIZE;
+}
+
+static size_t bench_find_char_sb(size_t n) { return bench_find_char_run(n, NULL); }
+static size_t bench_find_char_scalar(size_t n) { return bench_find_char_run(n, "scalar"); }
+static size_t bench_find_char_libc(size_t n){
+    size_t i;
+    for (i = 0; i < n; i++) bench_sink += (size_t)(const char*)memchr(bench_hay, '\r', BENCH_HAY_SIZE);
+    return n * BENCH_HAY_SIZE;
+}
+
+static size_t bench_find_sb(size_t n) { return bench_find_run(n, NULL); }
+static size_t bench_find_scalar(size_t n) { return bench_find_run(n, "scalar"); }
+static size_t bench_find_libc(size_t n){
+    size_t i;
+    for (i = 0; i < n; i++) bench_sink += (size_t)strstr(bench_hay, "HTTP/1.1");
+    return n * BENCH_HAY_SIZE;
+}
+
+static size_t bench_find_common_sb(size_t n) { return bench_find_common_run(n, NULL); }
+static size_t bench_find_common_scalar(size_t n) { return bench_find_common_run(n, "scalar"); }
+static size_t bench_find_common_libc(size_t n){
+    size_t i;
+    for (i = 0; i < n; i++) bench_sink += (size_t)strstr(bench_hay, "ahov\r\n");
+    return n * BENCH_HAY_SIZE;
+}
+
+static size_t bench_find_any_sb(size_t n) { return bench_find_any_run(n, NULL); }
+static size_t bench_find_any_scalar(size_t n) { return bench_find_any_run(n, "scalar"); }
+static size_t bench_find_any_libc(size_t n){
+    size_t i;
+    for (i = 0; i < n; i++) bench_sink += strcspn(bench_hay, "\r\n\"<>&");
+    return n * BENCH_HAY_SIZE;
+}
+
+static size_t bench_count_sb(size_t n) { return bench_count_run(n, NULL); }
+static size_t bench_count_scalar(size_t n) { return bench_count_run(n, "scalar"); }
+
+/* --- Escaping --- */
+
+/* 4 KiB of mostly clean text with one quote every 64 bytes (built on first use) */
+static const char *bench_text(void){
+    static char text[4096];
+    size_t i;
+
+    if (text[0] == '\0') {
+        for (i = 0; i < sizeof(text); i++) text[i] = (i % 64 == 63) ? '"' : (char)('a' + i % 26);
+    }
+    return text;
+}
+
+static size_t bench_json_sb(size_t iters){
+    SB_Buffer SB_INIT(b);
+    const char *text = bench_text();
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        sb_buffer_add_json_escaped(&b, text, 4096);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 4096;
+}
+
+/* Baseline: escape byte by byte, one append per byte or escape */
+static size_t bench_json_naive(size_t iters){
+    SB_Buffer SB_INIT(b);
+    const char *text = bench_text();
+    size_t i, j;
+
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        for (j = 0; j < 4096; j++) {
+            if (text[j] == '"') sb_buffer_add_literal(&b, "\\\"");
+            else if (text[j] == '\\') sb_buffer_add_literal(&b, "\\\\");
+            else sb_buffer_add_lstring(&b, text + j, 1);
+        }
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 4096;
+}
+
+static size_t bench_html_sb(size_t iters){
+    SB_Buffer SB_INIT(b);
+    const char *text = bench_text();
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        sb_buffer_add_html_escaped(&b, text, 4096);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 4096;
+}
+
+/* --- Hex / base64 --- */
+
+static size_t bench_hex_sb(size_t iters){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        sb_buffer_add_hex(&b, bench_data, 4096);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 4096;
+}
+
+/* Baseline: one appendf("%02x") per byte */
+static size_t bench_hex_printf(size_t iters){
+    SB_Buffer SB_INIT(b);
+    size_t i, j;
+
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        for (j = 0; j < 4096; j++) sb_buffer_appendf(&b, "%02x", (unsigned char)bench_data[j]);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 4096;
+}
+
+static size_t bench_hex_decode_sb(size_t iters){
+    SB_Buffer SB_INIT(hex);
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    sb_buffer_add_hex(&hex, bench_data, 4096);
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        sb_buffer_add_hex_decoded(&b, hex.str, hex.len);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    sb_buffer_finalize(&hex);
+    return iters * 8192;
+}
+
+static size_t bench_base64_sb(size_t iters){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        sb_buffer_add_base64(&b, bench_data, 4096);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 4096;
+}
+
+static size_t bench_base64_decode_sb(size_t iters){
+    SB_Buffer SB_INIT(text);
+    SB_Buffer SB_INIT(b);
+    size_t i, n;
+
+    sb_buffer_add_base64(&text, bench_data, 4096);
+    n = text.len;
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        sb_buffer_add_base64_decoded(&b, text.str, n);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    sb_buffer_finalize(&text);
+    return iters * n;
+}
+
+/* --- Pool --- */
+
+/* One request: a fresh buffer grown to 4 KiB, then dropped */
+static size_t bench_request_cycle(size_t iters, int pooled){
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        SB_Buffer SB_INIT(b);
+        if (pooled) sb_buffer_pool_acquire(&b, 4000);
+        else sb_buffer_reserve(&b, 4000);
+        sb_buffer_add_lstring(&b, bench_data, 4000);
+        bench_sink += b.len;
+        if (pooled) sb_buffer_pool_release(&b);
+        else sb_buffer_finalize(&b);
+    }
+    return iters * 4000;
+}
+
+static size_t bench_pool_sb(size_t n) { return bench_request_cycle(n, 1); }
+static size_t bench_pool_malloc(size_t n) { return bench_request_cycle(n, 0); }
+
+/* --- Log buffer (uncontended cost of one entry) --- */
+
+static size_t bench_logbuf_sb(size_t iters){
+    SB_LogBuffer lb;
+    size_t i;
+
+    if (!sb_logbuf_init(&lb, 64 * 1024)) return 0;
+    for (i = 0; i < iters; i++) {
+        if (!sb_logbuf_append(&lb, bench_data, 64)) {
+            bench_sink += sb_logbuf_swap(&lb)->len;
+            sb_logbuf_append(&lb, bench_data, 64);
+        }
+    }
+
+    bench_sink += sb_logbuf_swap(&lb)->len;
+    sb_logbuf_finalize(&lb);
+    return iters * 64;
+}
+
+/* Baseline: shared buffer behind a mutex */
+static size_t bench_logbuf_mutex(size_t iters){
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    sb_buffer_reserve(&b, 64 * 1024);
+    for (i = 0; i < iters; i++) {
+        pthread_mutex_lock(&lock);
+        if (b.len + 64 > 64 * 1024) {
+            bench_sink += b.len;
+            sb_buffer_clear(&b);
+        }
+        sb_buffer_add_lstring(&b, bench_data, 64);
+        pthread_mutex_unlock(&lock);
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 64;
+}
+
+/* --- File loading (4 MiB file, one byte read per page) --- */
+
+#define BENCH_FILE_SIZE (4u << 20)
+#define BENCH_FILE_PATH "/tmp/sb_bench_load.dat"
+
+static void bench_file_setup(void){
+    static int done = 0;
+    FILE *f;
+    size_t i;
+
+    if (done) return;
+    f = fopen(BENCH_FILE_PATH, "wb");
+    if (!f) return;
+    for (i = 0; i < BENCH_FILE_SIZE / BENCH_DATA_SIZE; i++) fwrite(bench_data, 1, BENCH_DATA_SIZE, f);
+    fclose(f);
+    done = 1;
+}
+
+static void bench_touch_pages(SB_Buffer *b){
+    size_t i;
+
+    for (i = 0; i < b->len; i += 4096) bench_sink += (unsigned char)b->str[i];
+}
+
+static size_t bench_load_mmap(size_t iters){
+    SB_Buffer SB_INIT(b);
+    SB_FileMap m;
+    size_t i;
+
+    bench_file_setup();
+    for (i = 0; i < iters; i++) {
+        if (!sb_buffer_load_file(&b, &m, BENCH_FILE_PATH)) return 0;
+        bench_touch_pages(&b);
+        sb_buffer_close_file(&b);
+    }
+    return iters * BENCH_FILE_SIZE;
+}
+
+/* Baseline: fread into a buffer grown to the file size */
+static size_t bench_load_fread(size_t iters){
+    SB_Buffer SB_INIT(b);
+    char *p;
+    size_t i;
+
+    bench_file_setup();
+    for (i = 0; i < iters; i++) {
+        FILE *f = fopen(BENCH_FILE_PATH, "rb");
+        if (!f) return 0;
+        sb_buffer_reset(&b);
+        p = sb_buffer_prepare(&b, BENCH_FILE_SIZE);
+        if (p) sb_buffer_commit(&b, fread(p, 1, BENCH_FILE_SIZE, f));
+        fclose(f);
+        bench_touch_pages(&b);
+    }
+
+    sb_buffer_finalize(&b);
+    return iters * BENCH_FILE_SIZE;
+}
+
+/* --- Sink (1 MiB response in 128-byte pieces, written to a counting sink) --- */
+
+static int bench_count_sink(void *ctx, const char *data, size_t len){
+    (void)data;
+    *(size_t*)ctx += len;
+    return 1;
+}
+
+static size_t bench_stream(size_t iters, int sink){
+    size_t out = 0, i, j;
+    SB_Sink s;
+
+    s.write_fn = bench_count_sink;
+    s.ctx = &out;
+    s.high_water = 0;
+    for (i = 0; i < iters; i++) {
+        SB_Buffer SB_INIT(b);
+        if (sink) sb_buffer_set_sink(&b, &s, 0);
+        for (j = 0; j < 8192; j++) sb_buffer_add_lstring(&b, bench_data + j % 64, 128);
+        if (sink) sb_buffer_flush(&b);
+        else bench_count_sink(&out, b.str, b.len);
+        sb_buffer_finalize(&b);
+    }
+
+    bench_sink += out;
+    return iters * 8192 * 128;
+}
+
+static size_t bench_stream_sink(size_t n) { return bench_stream(n, 1); }
+static size_t bench_stream_grow(size_t n) { return bench_stream(n, 0); }
+
+/* --- Write-out (responses of 4 x 1 KiB to /dev/null, 16 responses per submission) --- */
+
+static size_t bench_writeout(size_t iters, int uring){
+    SB_Buffer parts[4];
+    SB_Buffer *ptrs[4];
+    SB_Uring u;
+    size_t i;
+    int fd = open("/dev/null", O_WRONLY), k;
+
+    if (fd < 0 || (uring && !sb_uring_init(&u, 64))) return 0;
+    for (k = 0; k < 4; k++) {
+        sb_buffer_init(&parts[k]);
+        ptrs[k] = &parts[k];
+    }
+
+    for (i = 0; i < iters; i++) {
+        for (k = 0; k < 4; k++) {
+            sb_buffer_pool_acquire(&parts[k], 1024); /* No-op while the storage is kept */
+            sb_buffer_add_lstring(&parts[k], bench_data, 1024);
+        }
+        if (uring) {
+            sb_uring_queue(&u, fd, ptrs, 4, 0);
+            if (i % 16 == 15) sb_uring_submit(&u);
+        } else {
+            sb_buffer_writev_all(fd, ptrs, 4);
+            for (k = 0; k < 4; k++) sb_buffer_clear(&parts[k]);
+        }
+    }
+
+    if (uring) sb_uring_finalize(&u);
+    for (k = 0; k < 4; k++) sb_buffer_finalize(&parts[k]);
+    close(fd);
+    return iters * 4096;
+}
+
+static size_t bench_writeout_uring(size_t n) { return bench_writeout(n, 1); }
+static size_t bench_writeout_writev(size_t n) { return bench_writeout(n, 0); }
+
+/* --- Front Removal --- */
+
+/* Receive buffer: 16 KiB arrives, then is parsed in 64-byte messages from the front */
+static size_t bench_drain(size_t iters, int consume){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    for (i = 0; i < iters; i++) {
+        if (b.len < 64) sb_buffer_add_lstring(&b, bench_data, 16384);
+        bench_sink += (size_t)b.str[0];
+        if (consume) {
+            sb_buffer_consume(&b, 64);
+        } else {
+            memmove(b.str, b.str + 64, b.len - 64 + 1);
+            b.len -= 64;
+        }
+    }
+
+    sb_buffer_finalize(&b);
+    return iters * 64;
+}
+
+static size_t bench_drain_consume(size_t n) { return bench_drain(n, 1); }
+static size_t bench_drain_memmove(size_t n) { return bench_drain(n, 0); }
+
+/* --- Hashing and Interning --- */
+
+static size_t bench_hash(size_t iters, size_t len){
+    size_t i;
+
+    for (i = 0; i < iters; i++) bench_sink += (size_t)sb_hash_bytes(bench_data + (i & 63), len, 0);
+    return iters * len;
+}
+
+static size_t bench_hash_short(size_t n) { return bench_hash(n, 16); }
+static size_t bench_hash_4k(size_t n) { return bench_hash(n, 4096); }
+
+/* Same keys as bench_std_intern (bench_baseline.cpp) */
+static size_t bench_intern_sb(size_t iters){
+    SB_InternTable t;
+    char key[32];
+    size_t i, bytes = 0;
+
+    if (!sb_intern_init(&t, 4096)) return 0;
+    for (i = 0; i < iters; i++) {
+        int n = snprintf(key, sizeof(key), "x-header-%u", (unsigned)((i * 2654435761u) & 4095));
+        bench_sink += sb_intern(&t, key, (size_t)n);
+        bytes += (size_t)n;
+    }
+
+    sb_intern_finalize(&t);
+    return bytes;
+}
+
+/* --- Comparison --- */
+
+static const char *const bench_header_names[] = {
+    "Host", "User-Agent", "Accept", "Accept-Encoding", "Connection", "Content-Type",
+    "Content-Length", "Cache-Control", "Cookie", "X-Forwarded-For"
+};
+#define BENCH_HEADER_COUNT (sizeof(bench_header_names) / sizeof(bench_header_names[0]))
+
+/* Looks each incoming (lowercase) header name up in the known list, ignoring case */
+static size_t bench_header_match(size_t iters, int lib){
+    static const char *const incoming[] = {
+        "content-length", "host", "x-forwarded-for", "accept-encoding", "x-request-id", "cookie"
+    };
+    size_t lens[BENCH_HEADER_COUNT], i, j, bytes = 0;
+
+    for (j = 0; j < BENCH_HEADER_COUNT; j++) lens[j] = strlen(bench_header_names[j]);
+    for (i = 0; i < iters; i++) {
+        const char *name = incoming[i % 6];
+        size_t len = strlen(name);
+        for (j = 0; j < BENCH_HEADER_COUNT; j++) {
+            int hit = lib ? (len == lens[j] && sb_mem_equal_icase(name, bench_header_names[j], len))
+                          : strcasecmp(name, bench_header_names[j]) == 0;
+            if (hit) break;
+        }
+        bench_sink += j;
+        bytes += len;
+    }
+    return bytes;
+}
+
+static size_t bench_header_match_sb(size_t n) { return bench_header_match(n, 1); }
+static size_t bench_header_match_strcasecmp(size_t n) { return bench_header_match(n, 0); }
+
+/* --- Binary Mode --- */
+
+/* Frame encoder: 4-byte header + 12-byte field pairs into a 4 KiB block, sent when full */
+static size_t bench_frames(size_t iters, int binary){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    if (binary) sb_buffer_set_binary(&b, 1);
+    sb_buffer_reserve(&b, 4096);
+    for (i = 0; i < iters; i++) {
+        if (b.len + 16 > 4096) { bench_sink += b.cap; sb_buffer_clear(&b); }
+        if (binary) {
+            sb_buffer_add_data_fast(&b, bench_data + (i & 15), 4);
+            sb_buffer_add_data_fast(&b, bench_data + 32, 12);
+        } else {
+            sb_buffer_add_lstring_fast(&b, bench_data + (i & 15), 4);
+            sb_buffer_add_lstring_fast(&b, bench_data + 32, 12);
+        }
+    }
+
+    bench_sink += b.len;
+    sb_buffer_finalize(&b);
+    return iters * 16;
+}
+
+static size_t bench_frames_binary(size_t n) { return bench_frames(n, 1); }
+static size_t bench_frames_text(size_t n) { return bench_frames(n, 0); }
+
+/* --- Huge Pages --- */
+
+/* 256 MiB accumulator, then dependent random reads across it (TLB bound) */
+static size_t bench_huge_reads(size_t iters, int huge){
+    SB_HugeAllocator h;
+    SB_Buffer SB_INIT(b);
+    size_t i, pos = 0, len = (size_t)256 << 20;
+
+    if (huge) {
+        sb_huge_allocator_init(&h, 0, SB_HUGE_NUMA_LOCAL);
+        sb_buffer_set_allocator(&b, &h.allocator);
+    }
+    while (b.len < len) {
+        if (!sb_buffer_add_lstring(&b, bench_data, 65536)) { sb_buffer_finalize(&b); return 0; }
+    }
+
+    for (i = 0; i < iters; i++) {
+        pos = (pos * 6364136223846793005ull + 1442695040888963407ull + (unsigned char)b.str[pos % len]);
+        bench_sink += (unsigned char)b.str[pos % len];
+    }
+
+    sb_buffer_finalize(&b);
+    return iters;
+}
+
+static size_t bench_huge_reads_mapped(size_t n) { return bench_huge_reads(n, 1); }
+static size_t bench_huge_reads_malloc(size_t n) { return bench_huge_reads(n, 0); }
+
+/* --- Parallel Build --- */
+
+static int bench_format_records(void *ctx, SB_Buffer *out, size_t begin, size_t end){
+    size_t i;
+    (void)ctx;
+
+    for (i = begin; i < end; i++) {
+        if (!sb_buffer_add_literal(out, "{\"id\":") || !sb_buffer_add_u64(out, i) ||
+            !sb_buffer_add_literal(out, ",\"score\":") || !sb_buffer_add_double(out, (double)i / 7.0, 3) ||
+            !sb_buffer_add_literal(out, "}\n")) return 0;
+    }
+    return 1;
+}
+
+/* Formats iters records into one export buffer, on one thread or on every CPU */
+static size_t bench_export(size_t iters, int parallel){
+    SB_Buffer SB_INIT(b);
+    size_t bytes;
+
+    if (parallel) sb_buffer_build_parallel(&b, iters, 0, bench_format_records, NULL);
+    else bench_format_records(NULL, &b, 0, iters);
+
+    bytes = b.len;
+    sb_buffer_finalize(&b);
+    return bytes;
+}
+
+static size_t bench_export_parallel(size_t n) { return bench_export(n, 1); }
+static size_t bench_export_serial(size_t n) { return bench_export(n, 0); }
+
+/* --- UTF-8 --- */
+
+#define BENCH_UTF8_SIZE 4096
+
+static char bench_utf8[BENCH_UTF8_SIZE];
+static uint16_t bench_utf16[BENCH_UTF8_SIZE];
+static size_t bench_utf16_len;
+
+/* Mostly Cyrillic and ASCII text with some accents and emoji, in both encodings */
+static void bench_utf8_setup(void){
+    static const char sample[] = "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82, world! caf\xc3\xa9 \xe2\x82\xac 12 \xf0\x9f\x98\x80 ";
+    size_t i, n = 0;
+
+    if (bench_utf16_len) return;
+    for (i = 0; i + sizeof(sample) <= BENCH_UTF8_SIZE; i += sizeof(sample) - 1) memcpy(bench_utf8 + i, sample, sizeof(sample) - 1);
+    memset(bench_utf8 + i, ' ', BENCH_UTF8_SIZE - i);
+
+    for (i = 0; i < BENCH_UTF8_SIZE; ) {
+        unsigned char c = (unsigned char)bench_utf8[i];
+        uint32_t cp;
+        if (c < 0x80) { cp = c; i += 1; }
+        else if (c < 0xE0) { cp = ((c & 0x1Fu) << 6) | (bench_utf8[i + 1] & 0x3F); i += 2; }
+        else if (c < 0xF0) { cp = ((c & 0x0Fu) << 12) | ((bench_utf8[i + 1] & 0x3Fu) << 6) | (bench_utf8[i + 2] & 0x3F); i += 3; }
+        else {
+            cp = ((c & 0x07u) << 18) | ((bench_utf8[i + 1] & 0x3Fu) << 12) | ((bench_utf8[i + 2] & 0x3Fu) << 6) | (bench_utf8[i + 3] & 0x3F);
+            i += 4;
+        }
+        if (cp >= 0x10000) {
+            bench_utf16[n++] = (uint16_t)(0xD800 + ((cp - 0x10000) >> 10));
+            cp = 0xDC00 + ((cp - 0x10000) & 0x3FF);
+        }
+        bench_utf16[n++] = (uint16_t)cp;
+    }
+    bench_utf16_len = n;
+}
+
+/* Byte-at-a-time decoder check, the usual hand-written loop */
+static int bench_utf8_valid_naive(const unsigned char *s, size_t n){
+    size_t i = 0;
+    while (i < n) {
+        unsigned c = s[i], k, j;
+        uint32_t cp;
+        if (c < 0x80) { i++; continue; }
+        if ((c & 0xE0) == 0xC0) { k = 1; cp = c & 0x1F; }
+        else if ((c & 0xF0) == 0xE0) { k = 2; cp = c & 0x0F; }
+        else if ((c & 0xF8) == 0xF0) { k = 3; cp = c & 0x07; }
+        else return 0;
+        if (n - i <= k) return 0;
+        for (j = 1; j <= k; j++) {
+            if ((s[i + j] & 0xC0) != 0x80) return 0;
+            cp = (cp << 6) | (s[i + j] & 0x3F);
+        }
+        if (cp < (k == 1 ? 0x80u : k == 2 ? 0x800u : 0x10000u) || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000)) return 0;
+        i += k + 1;
+    }
+    return 1;
+}
+
+/* Validated appends of a 4 KiB document into a reused buffer */
+static size_t bench_utf8_validate(size_t iters, int lib){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    bench_utf8_setup();
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        if (lib) bench_sink += (size_t)sb_buffer_add_utf8_validated(&b, bench_utf8, BENCH_UTF8_SIZE);
+        else if (bench_utf8_valid_naive((const unsigned char*)bench_utf8, BENCH_UTF8_SIZE)) bench_sink += (size_t)sb_buffer_add_lstring(&b, bench_utf8, BENCH_UTF8_SIZE);
+    }
+
+    sb_buffer_finalize(&b);
+    return iters * BENCH_UTF8_SIZE;
+}
+
+/* The same document from UTF-16, against a unit-at-a-time encoder appending per code point */
+static size_t bench_transcode(size_t iters, int lib){
+    SB_Buffer SB_INIT(b);
+    size_t i, j;
+
+    bench_utf8_setup();
+    for (i = 0; i < iters; i++) {
+        sb_buffer_clear(&b);
+        if (lib) { bench_sink += (size_t)sb_buffer_add_utf16_as_utf8(&b, bench_utf16, bench_utf16_len); continue; }
+        for (j = 0; j < bench_utf16_len; j++) {
+            uint32_t c = bench_utf16[j];
+            char e[4];
+            size_t k;
+            if (c >= 0xD800 && c < 0xDC00) c = 0x10000 + ((c - 0xD800) << 10) + (uint32_t)(bench_utf16[++j] - 0xDC00);
+            if (c < 0x80) { e[0] = (char)c; k = 1; }
+            else if (c < 0x800) { e[0] = (char)(0xC0 | (c >> 6)); e[1] = (char)(0x80 | (c & 0x3F)); k = 2; }
+            else if (c < 0x10000) { e[0] = (char)(0xE0 | (c >> 12)); e[1] = (char)(0x80 | ((c >> 6) & 0x3F)); e[2] = (char)(0x80 | (c & 0x3F)); k = 3; }
+            else {
+                e[0] = (char)(0xF0 | (c >> 18)); e[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+                e[2] = (char)(0x80 | ((c >> 6) & 0x3F)); e[3] = (char)(0x80 | (c & 0x3F)); k = 4;
+            }
+            sb_buffer_add_lstring(&b, e, k);
+        }
+        bench_sink += b.len;
+    }
+
+    sb_buffer_finalize(&b);
+    return iters * bench_utf16_len * 2;
+}
+
+static size_t bench_utf8_validate_sb(size_t n) { return bench_utf8_validate(n, 1); }
+static size_t bench_utf8_validate_naive(size_t n) { return bench_utf8_validate(n, 0); }
+static size_t bench_utf16_sb(size_t n) { return bench_transcode(n, 1); }
+static size_t bench_utf16_naive(size_t n) { return bench_transcode(n, 0); }
+
+/* --- Registry --- */
+
+static const SB_Bench benches[] = {
+    { "append_tiny", "sb_buffer", bench_tiny_sb, 20000000 },
+    { "append_tiny", "sb_buffer_fast", bench_tiny_fast, 20000000 },
+    { "append_tiny", "memcpy", bench_tiny_memcpy, 20000000 },
+    { "append_tiny", "strcat", bench_tiny_strcat, 2000000 },
+    { "append_tiny", "std_string", bench_tiny_std, 20000000 },
+    { "append_medium", "sb_buffer", bench_medium_sb, 5000000 },
+    { "append_medium", "sb_buffer_fast", bench_medium_fast, 5000000 },
+    { "append_medium", "memcpy", bench_medium_memcpy, 5000000 },
+    { "append_medium", "strcat", bench_medium_strcat, 1000000 },
+    { "append_medium", "std_string", bench_medium_std, 5000000 },
+    { "append_huge", "sb_buffer", bench_huge_sb, 20000 },
+    { "append_huge", "sb_buffer_fast", bench_huge_fast, 20000 },
+    { "append_huge", "memcpy", bench_huge_memcpy, 20000 },
+    { "append_huge", "std_string", bench_huge_std, 20000 },
+    { "sso_below", "sb_buffer", bench_sso_below, 5000000 },
+    { "sso_cross", "sb_buffer", bench_sso_cross, 2000000 },
+    { "reuse_clear", "sb_buffer", bench_reuse_clear, 5000000 },
+    { "reuse_reset", "sb_buffer", bench_reuse_reset, 2000000 },
+    { "copy_small", "sb_buffer", bench_copy_small_sb, 10000000 },
+    { "copy_small", "memcpy", bench_copy_small_memcpy, 10000000 },
+    { "copy_small", "std_string", bench_copy_small_std, 10000000 },
+    { "copy_large", "sb_buffer", bench_copy_large_sb, 1000000 },
+    { "copy_large", "memcpy", bench_copy_large_memcpy, 1000000 },
+    { "copy_large", "std_string", bench_copy_large_std, 1000000 },
+    { "move_heap", "sb_buffer", bench_move_heap, 10000000 },
+    { "vector_pipeline", "sb_buffer_hpp", bench_pipeline_cpp, 2000000 },
+    { "vector_pipeline", "std_string", bench_pipeline_std, 2000000 },
+    { "http_header", "separate_appends", bench_cpp_header_chain, 10000000 },
+    { "http_header", "variadic_append", bench_cpp_header_append, 10000000 },
+    { "find_char", "sb_buffer", bench_find_char_sb, 100000 },
+    { "find_char", "scalar", bench_find_char_scalar, 100000 },
+    { "find_char", "libc_memchr", bench_find_char_libc, 100000 },
+    { "find", "sb_buffer", bench_find_sb, 50000 },
+    { "find", "scalar", bench_find_scalar, 50000 },
+    { "find", "libc_strstr", bench_find_libc, 50000 },
+    { "find_common", "sb_buffer", bench_find_common_sb, 50000 },
+    { "find_common", "scalar", bench_find_common_scalar, 10000 },
+    { "find_common", "libc_strstr", bench_find_common_libc, 10000 },
+    { "find_any", "sb_buffer", bench_find_any_sb, 50000 },
+    { "find_any", "scalar", bench_find_any_scalar, 20000 },
+    { "find_any", "libc_strcspn", bench_find_any_libc, 20000 },
+    { "json_escape", "sb_buffer", bench_json_sb, 200000 },
+    { "json_escape", "naive", bench_json_naive, 20000 },
+    { "html_escape", "sb_buffer", bench_html_sb, 200000 },
+    { "hex_encode", "sb_buffer", bench_hex_sb, 200000 },
+    { "hex_encode", "appendf", bench_hex_printf, 2000 },
+    { "hex_decode", "sb_buffer", bench_hex_decode_sb, 200000 },
+    { "base64_encode", "sb_buffer", bench_base64_sb, 200000 },
+    { "base64_decode", "sb_buffer", bench_base64_decode_sb, 200000 },
+    { "request_cycle", "sb_pool", bench_pool_sb, 1000000 },
+    { "request_cycle", "malloc", bench_pool_malloc, 1000000 },
+    { "log_append", "sb_logbuf", bench_logbuf_sb, 5000000 },
+    { "log_append", "mutex", bench_logbuf_mutex, 5000000 },
+    { "load_file", "sb_mmap", bench_load_mmap, 500 },
+    { "load_file", "fread", bench_load_fread, 500 },
+    { "stream_1mb", "sink", bench_stream_sink, 2000 },
+    { "stream_1mb", "grow", bench_stream_grow, 2000 },
+    { "writeout", "sb_uring", bench_writeout_uring, 200000 },
+    { "writeout", "writev", bench_writeout_writev, 200000 },
+    { "drain_front", "sb_consume", bench_drain_consume, 5000000 },
+    { "drain_front", "memmove", bench_drain_memmove, 5000000 },
+    { "hash_16b", "sb_hash", bench_hash_short, 50000000 },
+    { "hash_4k", "sb_hash", bench_hash_4k, 500000 },
+    { "intern", "sb_intern", bench_intern_sb, 5000000 },
+    { "intern", "std_unordered_map", bench_std_intern, 5000000 },
+    { "header_match", "sb_mem_equal_icase", bench_header_match_sb, 5000000 },
+    { "header_match", "strcasecmp", bench_header_match_strcasecmp, 5000000 },
+    { "frame_encode", "binary_mode", bench_frames_binary, 20000000 },
+    { "frame_encode", "text_mode", bench_frames_text, 20000000 },
+    { "random_read_256m", "sb_huge", bench_huge_reads_mapped, 5000000 },
+    { "random_read_256m", "malloc", bench_huge_reads_malloc, 5000000 },
+    { "export_records", "build_parallel", bench_export_parallel, 2000000 },
+    { "export_records", "single_thread", bench_export_serial, 2000000 },
+    { "utf8_validate_4k", "sb_buffer_add_utf8_validated", bench_utf8_validate_sb, 200000 },
+    { "utf8_validate_4k", "naive_loop", bench_utf8_validate_naive, 50000 },
+    { "utf16_to_utf8_4k", "sb_buffer_add_utf16_as_utf8", bench_utf16_sb, 200000 },
+    { "utf16_to_utf8_4k", "naive_loop", bench_utf16_naive, 20000 },
+    { "count_char", "sb_buffer", bench_count_sb, 50000 },
+    { "count_char", "scalar", bench_count_scalar, 20000 },
+};
+
+/* --- Driver --- */
+
+static double bench_now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char **argv){
+    const char *filter = NULL;
+    double scale = 1.0;
+    int reps = 3;
+    size_t i;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--filter") && a + 1 < argc) filter = argv[++a];
+        else if (!strcmp(argv[a], "--scale") && a + 1 < argc) scale = atof(argv[++a]);
+        else if (!strcmp(argv[a], "--reps") && a + 1 < argc) reps = atoi(argv[++a]);
+        else {
+            fprintf(stderr, "usage: %s [--filter substring] [--scale factor] [--reps n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (scale <= 0) scale = 1.0;
+    if (reps < 1) reps = 1;
+
+    for (i = 0; i < BENCH_DATA_SIZE; i++) bench_data[i] = (char)('a' + i % 26);
+    bench_hay_setup();
+
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        const SB_Bench *bench = &benches[i];
+        size_t iters = (size_t)((double)bench->iters * scale);
+        double best = 0;
+        size_t bytes = 0;
+        int r;
+
+        if (filter && !strstr(bench->name, filter) && !strstr(bench->impl, filter)) continue;
+        if (iters == 0) iters = 1;
+
+        for (r = 0; r < reps; r++) {
+            double t0 = bench_now_ns();
+            bytes = bench->run(iters);
+            t0 = bench_now_ns() - t0;
+            if (r == 0 || t0 < best) best = t0;
+        }
+        if (best <= 0) best = 1;
+
+        printf("{\"bench\":\"%s\",\"impl\":\"%s\",\"iters\":%zu,\"ns_per_op\":%.3f,\"bytes_per_sec\":%.0f}\n",
+               bench->name, bench->impl, iters, best / (double)iters, (double)bytes * 1e9 / best);
+        fflush(stdout);
+    }
+
+    sb_buffer_finalize(&bench_hay_buf);
+    remove(BENCH_FILE_PATH);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*!
+ * @file sb_arena.h
+ * @brief Bump-pointer arena that can back the heap storage of SB_Buffer instances.
+ *
+ * Typical use is one arena per request: every buffer of the request grows
+ * inside the arena (no global allocator lock), and everything is released
+ * with a single sb_arena_finalize() at the end. The most recently allocated
+ * block can grow in place, so a buffer that sits at the top of the arena
+ * never copies its content when it expands.
+ */
+#ifndef SB_ARENA_H
+#define SB_ARENA_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Default size of each arena chunk. */
+#ifndef SB_ARENA_CHUNK_SIZE
+#define SB_ARENA_CHUNK_SIZE 65536
+#endif
+
+/*! @brief Alignment of every block handed out by the arena. */
+#define SB_ARENA_ALIGN 16
+
+/*! @brief Internal chunk header; the data area follows it. */
+typedef struct SB_ArenaChunk {
+    struct SB_ArenaChunk *next;
+    size_t size;  /* Size of the data area */
+    size_t used;  /* Bytes consumed in the data area */
+} SB_ArenaChunk;
+
+/*!
+ * @struct SB_Arena
+ * @brief Chunked bump-pointer arena.
+ */
+typedef struct {
+    SB_Allocator allocator; /* Vtable handed to buffers (ctx is the arena) */
+    SB_ArenaChunk *head;    /* Current chunk: allocations happen at its top */
+    size_t chunk_size;
+} SB_Arena;
+
+/*!
+ * @brief Initializes an empty arena. No memory is taken until the first allocation.
+ * @param a Pointer to the arena.
+ * @param chunk_size Size of each chunk, or 0 for SB_ARENA_CHUNK_SIZE.
+ * @return int 1 on success, 0 if the pointer is NULL.
+ */
+int sb_arena_init(SB_Arena *a, size_t chunk_size);
+
+/*!
+ * @brief Returns the allocator vtable to pass to sb_buffer_set_allocator().
+ * @param a Pointer to the arena.
+ * @return const SB_Allocator* The arena allocator, or NULL if the pointer is NULL.
+ */
+const SB_Allocator *sb_arena_allocator(SB_Arena *a);
+
+/*!
+ * @brief Allocates size bytes from the arena.
+ * @param a Pointer to the arena.
+ * @param size Number of bytes.
+ * @return void* The block, or NULL on memory allocation failure.
+ */
+void *sb_arena_alloc(SB_Arena *a, size_t size);
+
+/*!
+ * @brief Forgets every allocation but keeps the first chunk for reuse.
+ *
+ * Only a chunk of the base size is kept: oversized chunks opened for large
+ * requests are released, so a reset arena holds at most chunk_size bytes.
+ * @note Buffers backed by the arena must not be used after this call.
+ * @param a Pointer to the arena.
+ * @return int 1 on success, 0 if the pointer is NULL.
+ */
+int sb_arena_reset(SB_Arena *a);
+
+/*!
+ * @brief Releases all the chunks of the arena in bulk.
+ * @note Buffers backed by the arena must not be used after this call.
+ * @param a Pointer to the arena.
+ * @return int 1 on success, 0 if the pointer is NULL.
+ */
+int sb_arena_finalize(SB_Arena *a);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_ARENA_H */
@@ -13,6 +13,7 @@
 #include <string.h> /* For strlen */
 #include <stdint.h> /* For uint32_t */
 #include <stdio.h> /* For fprintf (used in debug macro) */
+#include <stdarg.h> /* For va_list */
 
 
 /* C++ compatibility wrapper */
@@ -30,18 +31,184 @@ extern "C" {
 /*! @brief Unique value used to identify a valid Buffer instance. */
 #define SB_BUFFER_MAGIC 0xBABECAFE
 
+/*!
+ * @enum SB_Growth
+ * @brief Capacity growth policies used when an append does not fit.
+ */
+typedef enum {
+    SB_GROWTH_DOUBLE = 0,     /*!< Doubles the capacity (default). */
+    SB_GROWTH_1_5X = 1,       /*!< Grows by 1.5x: less slack in long-lived buffers. */
+    SB_GROWTH_PAGE = 2,       /*!< 1.5x, rounded up to SB_BUFFER_PAGE_SIZE once past one page. */
+    SB_GROWTH_SIZE_CLASS = 3  /*!< 1.25x, rounded up to jemalloc-style size classes. */
+} SB_Growth;
+
+/*! @brief Compile-time default growth policy for new buffers. */
+#ifndef SB_BUFFER_DEFAULT_GROWTH
+#define SB_BUFFER_DEFAULT_GROWTH SB_GROWTH_DOUBLE
+#endif
+
+/*! @brief Page size used by the SB_GROWTH_PAGE policy. */
+#ifndef SB_BUFFER_PAGE_SIZE
+#define SB_BUFFER_PAGE_SIZE 4096
+#endif
+
+/*! @brief Bits of SB_Buffer::flags holding the SB_Growth policy. */
+#define SB_BUFFER_GROWTH_MASK 0x3u
+
+/*! @brief Mode bit of SB_Buffer::flags: binary content, terminated lazily (see sb_buffer_set_binary). */
+#define SB_BUFFER_BINARY 0x4u
+
+/*!
+ * @struct SB_Allocator
+ * @brief Allocator vtable used for the heap storage of a buffer.
+ *
+ * Every hook receives the user context. The realloc and free hooks also
+ * receive the current block size, so that size-aware allocators (arenas,
+ * size-class pools) do not need to keep headers.
+ */
+typedef struct SB_Allocator {
+    void *(*alloc_fn)(void *ctx, size_t size);
+    void *(*realloc_fn)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} SB_Allocator;
+
+/*! @brief The standard malloc/realloc/free allocator (the default). */
+extern const SB_Allocator sb_buffer_malloc_allocator;
+
+/* Portable inline / cold function qualifiers */
+#if defined(__cplusplus) || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)
+#define SB_BUFFER_INLINE static inline
+#else
+#define SB_BUFFER_INLINE static __inline
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SB_BUFFER_COLD __attribute__((cold, noinline))
+#define SB_BUFFER_LIKELY(x) __builtin_expect(!!(x), 1)
+#define SB_BUFFER_PRINTF(f, a) __attribute__((format(printf, f, a)))
+#else
+#define SB_BUFFER_COLD
+#define SB_BUFFER_LIKELY(x) (x)
+#define SB_BUFFER_PRINTF(f, a)
+#endif
+
+/*!
+ * @struct SB_Sink
+ * @brief Destination that receives the content of a sink-backed buffer.
+ *
+ * write_fn must consume all len bytes and return 1, or return 0 on error.
+ * The struct is owned by the caller and also carries the state of the sink
+ * mode, so that growing buffers do not pay for it: a sink serves one buffer
+ * at a time.
+ */
+typedef struct {
+    int (*write_fn)(void *ctx, const char *data, size_t len);
+    void *ctx;
+    size_t high_water; /* Largest content the buffer keeps (set by sb_buffer_set_sink) */
+} SB_Sink;
+
+/*! @brief Default high-water mark of sb_buffer_set_sink() (a 64 KiB block). */
+#define SB_BUFFER_SINK_HIGH_WATER (65536 - 1)
+
+/*! @brief Offset meaning "not found" / "until the end". */
+#define SB_BUFFER_NPOS ((size_t)-1)
+
+/*! @brief Largest number of decimals accepted by sb_buffer_add_double(). */
+#define SB_BUFFER_DOUBLE_MAX_DECIMALS 9
+
+/*!
+ * @brief Fields shared by every buffer type, whatever its inline capacity.
+ *
+ * The hot fields (str, len, cap and the hash cache every mutation clears)
+ * come first, followed by the rest of the header, so that the header is
+ * contiguous and precedes the inline storage. State used by few buffers
+ * lives in caller-owned structs (the sink), and the header must not exceed
+ * 64 bytes (checked at compile time in sb_buffer.c).
+ */
+#define SB_BUFFER_HEADER \
+    char *str;                  /* Current storage: init or a heap block */ \
+    size_t len;                 /* Content length (excluding the terminator) */ \
+    size_t cap;                 /* Size of the storage from str on */ \
+    uint64_t hash;              /* Cached content hash (sb_hash.h), 0 when unknown */ \
+    uint32_t magic;             /* Signature for validity check */ \
+    uint32_t flags;             /* Growth policy and mode bits */ \
+    const SB_Allocator *alloc;  /* Owner of the heap storage */ \
+    SB_Sink *sink;              /* Flush target and its high-water mark, NULL for a growing buffer */ \
+    uint32_t inline_cap;        /* Size of the inline init array */ \
+    uint32_t head;              /* Bytes consumed from the front of a heap block (str - head starts it) */
+
+/*!
+ * @brief Optional cache line alignment of buffer types.
+ *
+ * Define SB_BUFFER_CACHELINE_ALIGN to align every buffer type on a 64-byte
+ * boundary. The header is at most 64 bytes (exactly 64 on LP64 targets), so
+ * it then occupies a single cache line and the inline storage starts on the
+ * next one: an aligned SB_Buffer16 or SB_BufferHeap takes two lines.
+ */
+#if defined(SB_BUFFER_CACHELINE_ALIGN) && (defined(__GNUC__) || defined(__clang__))
+#define SB_BUFFER_ALIGNMENT __attribute__((aligned(64)))
+#else
+#define SB_BUFFER_ALIGNMENT
+#endif
+
+/*!
+ * @brief Declares a buffer type with N bytes of inline (SSO) storage.
+ *
+ * All the types share the SB_Buffer layout up to the init array, so they are
+ * used through the regular API by passing SB_BUFFER_AS(&b).
+ * e.g. SB_BUFFER_DEFINE(SB_Buffer32, 32);
+ */
+#define SB_BUFFER_DEFINE(name, N) \
+    typedef struct { SB_BUFFER_HEADER char init[N]; } SB_BUFFER_ALIGNMENT name
+
 /*!
  * @struct Buffer
  * @brief Structure representing a dynamic string buffer with Small String Optimization (SSO).
  */
+SB_BUFFER_DEFINE(SB_Buffer, SB_BUFFER_INITIAL_CAP);
+
+/*! @brief Buffer with 16 bytes of inline storage. */
+SB_BUFFER_DEFINE(SB_Buffer16, 16);
+
+/*! @brief Buffer with 64 bytes of inline storage. */
+SB_BUFFER_DEFINE(SB_Buffer64, 64);
+
+/*! @brief Heap-only buffer: the inline storage only holds the empty string. */
+SB_BUFFER_DEFINE(SB_BufferHeap, 1);
+
+/*! @brief Views any buffer type declared with SB_BUFFER_DEFINE as an SB_Buffer. */
+#define SB_BUFFER_AS(p) ((SB_Buffer*)(void*)(p))
+
+/*!
+ * @brief Storage kept free after the content: 1 byte for the terminator, none in binary mode.
+ *
+ * For code that writes b->str directly: SB_BUFFER_ROOM(b) bytes can be
+ * appended without growing, and SB_BUFFER_TERMINATE(b) restores the
+ * terminator afterwards (a no-op in binary mode).
+ */
+#define SB_BUFFER_TAIL(b) ((size_t)(((b)->flags & SB_BUFFER_BINARY) == 0))
+#define SB_BUFFER_ROOM(b) ((b)->cap - (b)->len - SB_BUFFER_TAIL(b))
+#define SB_BUFFER_TERMINATE(b) \
+    do { if (SB_BUFFER_TAIL(b)) (b)->str[(b)->len] = '\0'; } while (0)
+
+/*!
+ * @brief Part of the inline storage in use: all of it, or only high_water
+ * plus the tail for a sink-backed buffer, so that appends flush on time.
+ */
+#define SB_BUFFER_INLINE_LIMIT(b) \
+    ((b)->sink && (b)->sink->high_water + SB_BUFFER_TAIL(b) < (b)->inline_cap ? \
+     (b)->sink->high_water + SB_BUFFER_TAIL(b) : (size_t)(b)->inline_cap)
+
+
+/*!
+ * @struct SB_Slice
+ * @brief A (pointer, length) pair; same layout as struct iovec.
+ */
 typedef struct {
-    /*! @var uint32_t magic */
-    uint32_t magic;      /* Signature for validity check */
-    char init[SB_BUFFER_INITIAL_CAP];
-    char *str;
+    const void *base;
     size_t len;
-    size_t cap;
-} SB_Buffer;
+} SB_Slice;
 
 
 /* --- Function Prototypes --- */
@@ -57,6 +224,16 @@ typedef struct {
  */
 int sb_buffer_init(SB_Buffer *b);
 
+/*!
+ * @brief Initializes a buffer whose init array holds inline_cap bytes.
+ *
+ * Used for the types declared with SB_BUFFER_DEFINE; see SB_BUFFER_INIT_SIZED.
+ * @param b Pointer to the buffer, viewed as an SB_Buffer.
+ * @param inline_cap Size of the init array (at least 1, at most UINT32_MAX).
+ * @return int 1 on success, 0 if the pointer is NULL or inline_cap is out of range.
+ */
+int sb_buffer_init_inline(SB_Buffer *b, size_t inline_cap);
+
 /*!
  * @brief Checks if the given pointer is a valid, initialized Buffer structure.
  * Verifies that the pointer is not NULL and that the structure contains the correct magic number.
@@ -74,15 +251,25 @@ int sb_buffer_finalize(SB_Buffer *b);
 
 /*!
  * @brief Returns the raw C string pointer.
+ *
+ * In binary mode this is where the terminator gets written; when the content
+ * fills the storage exactly, the block first grows by one byte.
  * @param b Pointer to the Buffer structure.
- * @return const char* Pointer to the null-terminated string, or NULL if the pointer is invalid.
+ * @return const char* Pointer to the null-terminated string, or NULL if the pointer is invalid (or memory allocation failed).
  */
 const char *sb_buffer_get_str(SB_Buffer *b);
 
+/*!
+ * @brief Returns the content without guaranteeing a terminator (binary-safe).
+ * @param b Pointer to the Buffer structure.
+ * @return const char* Pointer to the sb_buffer_get_len() content bytes, or NULL if the pointer is invalid.
+ */
+const char *sb_buffer_data(SB_Buffer *b);
+
 /*!
  * @brief Adds a string of known length to the buffer.
  *
- * Resizes the buffer if required using a doubling strategy.
+ * Resizes the buffer if required using its growth policy (doubling by default).
  * @param b Pointer to the Buffer structure.
  * @param s Pointer to the source string.
  * @param len Length of the source string to append.
@@ -90,6 +277,262 @@ const char *sb_buffer_get_str(SB_Buffer *b);
  */
 int sb_buffer_add_lstring(SB_Buffer *b, const char *s, size_t len);
 
+/*!
+ * @brief Out-of-line slow path of the append: grows the buffer, then appends.
+ *
+ * Called by the inline fast path when the data does not fit in the remaining
+ * capacity. Performs no magic number validation.
+ * @param b Pointer to a valid Buffer structure.
+ * @param s Pointer to the source string.
+ * @param len Length of the source string to append.
+ * @return int 1 on success, 0 on memory allocation failure.
+ */
+int sb_buffer_add_lstring_slow(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Appends an array of pieces with a single capacity check.
+ *
+ * Adds up the lengths, grows at most once and copies all the pieces in one
+ * pass. An array of struct iovec can be passed by casting it to SB_Slice.
+ * A sink-backed buffer that cannot hold them all flushes first and then
+ * takes them piece by piece. If the sink refuses the first of these writes,
+ * none of the pieces is appended; a later failure keeps the pieces before
+ * it (written, or still in the buffer).
+ * @param b Pointer to the Buffer structure.
+ * @param parts Array of (pointer, length) pairs.
+ * @param count Number of entries in parts.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_many(SB_Buffer *b, const SB_Slice *parts, size_t count);
+
+/*!
+ * @brief Reserves room for n more bytes and returns a pointer to write them.
+ *
+ * Lets read()/recv()/decoders write straight into the buffer storage. Pair
+ * it with sb_buffer_commit(); the content is unchanged until then.
+ * e.g. p = sb_buffer_prepare(&b, 4096); n = read(fd, p, 4096); sb_buffer_commit(&b, n);
+ * @param b Pointer to the Buffer structure.
+ * @param n Number of bytes the caller may write.
+ * @return char* Pointer to the spare capacity (b->str + b->len), or NULL on failure.
+ * @note The pointer is invalidated by any other call that may grow the buffer.
+ */
+char *sb_buffer_prepare(SB_Buffer *b, size_t n);
+
+/*!
+ * @brief Appends the bytes written in place after sb_buffer_prepare().
+ *
+ * Advances the length and writes the null terminator (skipped in binary mode).
+ * @param b Pointer to the Buffer structure.
+ * @param written Number of bytes actually written (may be less than prepared).
+ * @return int 1 on success, 0 if written exceeds the spare capacity or the pointer is invalid.
+ */
+int sb_buffer_commit(SB_Buffer *b, size_t written);
+
+/*!
+ * @brief Appends printf-style formatted text.
+ *
+ * Formats directly into the spare capacity; only when the output does not fit
+ * does it grow (once, to the exact size) and format again.
+ * @param b Pointer to the Buffer structure.
+ * @param fmt printf format string.
+ * @return int 1 on success, 0 on failure (formatting error, memory allocation failed or invalid input).
+ */
+int sb_buffer_appendf(SB_Buffer *b, const char *fmt, ...) SB_BUFFER_PRINTF(2, 3);
+
+/*!
+ * @brief va_list version of sb_buffer_appendf().
+ * @param b Pointer to the Buffer structure.
+ * @param fmt printf format string.
+ * @param ap Argument list.
+ * @return int 1 on success, 0 on failure (formatting error, memory allocation failed or invalid input).
+ */
+int sb_buffer_vappendf(SB_Buffer *b, const char *fmt, va_list ap);
+
+/*!
+ * @brief Appends the decimal form of an unsigned 64-bit integer (table driven, no locale).
+ * @param b Pointer to the Buffer structure.
+ * @param v Value to append.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_u64(SB_Buffer *b, uint64_t v);
+
+/*!
+ * @brief Appends the decimal form of a signed 64-bit integer (table driven, no locale).
+ * @param b Pointer to the Buffer structure.
+ * @param v Value to append.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_i64(SB_Buffer *b, int64_t v);
+
+/*!
+ * @brief Appends a double in fixed notation with the given number of decimals.
+ *
+ * Equivalent to "%.*f" but locale independent and without printf parsing:
+ * rounding is decided on the exact binary value, ties to even. "nan", "inf"
+ * and "-inf" are written for special values; magnitudes of 1e18 and above
+ * fall back to exponent notation.
+ * @param b Pointer to the Buffer structure.
+ * @param v Value to append.
+ * @param decimals Digits after the point, clamped to [0, SB_BUFFER_DOUBLE_MAX_DECIMALS].
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_double(SB_Buffer *b, double v, int decimals);
+
+/*!
+ * @brief Ensures the buffer can hold n bytes of content without reallocating.
+ *
+ * Use it when the final length is known up front: the block is sized exactly
+ * (n + 1 bytes for the terminator, n in binary mode), bypassing the growth
+ * policy. Never shrinks.
+ * @param b Pointer to the Buffer structure.
+ * @param n Total content length to make room for (excluding the null terminator).
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_reserve(SB_Buffer *b, size_t n);
+
+/*!
+ * @brief Releases unused heap capacity.
+ *
+ * Moves the content back to the internal stack array when it fits there,
+ * otherwise reallocates the heap block to exactly len + 1 bytes (len in binary mode).
+ * @param b Pointer to the Buffer structure.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_shrink_to_fit(SB_Buffer *b);
+
+/*!
+ * @brief Selects the growth policy used by subsequent appends on this buffer.
+ * @param b Pointer to the Buffer structure.
+ * @param policy One of the SB_Growth values.
+ * @return int 1 on success, 0 if the pointer or the policy is invalid.
+ */
+int sb_buffer_set_growth(SB_Buffer *b, SB_Growth policy);
+
+/*!
+ * @brief Switches the buffer into or out of binary mode.
+ *
+ * In binary mode appends skip the terminator store and reserve no byte for
+ * it: sb_buffer_reserve(b, 4096) asks the allocator for exactly 4096 bytes
+ * and a buffer holds as many bytes as its capacity. The content is only
+ * terminated by sb_buffer_get_str(); read it through sb_buffer_data() and
+ * sb_buffer_get_len() instead. sb_buffer_move() carries the mode along
+ * with the content.
+ * @param b Pointer to the Buffer structure.
+ * @param on 1 to enter binary mode, 0 to return to text mode (terminating the content).
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_set_binary(SB_Buffer *b, int on);
+
+/*!
+ * @brief Sets the allocator assigned to buffers initialized from now on.
+ *
+ * Buffers keep the allocator they were initialized with; changing the
+ * default does not affect existing buffers. Not thread-safe: call it at startup.
+ * @param a Allocator to use, or NULL to restore sb_buffer_malloc_allocator.
+ */
+void sb_buffer_set_default_allocator(const SB_Allocator *a);
+
+/*!
+ * @brief Returns the allocator assigned to newly initialized buffers.
+ * @return const SB_Allocator* The current default allocator.
+ */
+const SB_Allocator *sb_buffer_get_default_allocator(void);
+
+/*!
+ * @brief Sets the allocator of a single buffer.
+ *
+ * If the buffer already lives on the heap, its content is moved to a block
+ * obtained from the new allocator and the old block is released.
+ * @param b Pointer to the Buffer structure.
+ * @param a Allocator to use, or NULL for sb_buffer_malloc_allocator.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_set_allocator(SB_Buffer *b, const SB_Allocator *a);
+
+/*!
+ * @brief Attaches a sink: the buffer flushes instead of growing.
+ *
+ * The storage is resized to exactly high_water + 1 bytes (high_water in
+ * binary mode): part of the inline array when it is large enough, otherwise
+ * one heap block, and a larger block the buffer already had is released.
+ * From then on, an append that does not fit writes the
+ * content to the sink and empties the buffer first, so memory stays fixed
+ * whatever the size of the output; a single piece larger than the buffer is
+ * handed to the sink directly by the lstring/many appends (prepare and
+ * appendf still grow for it). Call sb_buffer_flush() at the end: finalize
+ * does not flush. The high-water mark is recorded in sink->high_water.
+ * On failure the buffer keeps its previous sink (or none) and storage.
+ * @param b Pointer to the Buffer structure.
+ * @param sink Sink to attach (must outlive the buffer, one buffer per sink), or NULL to detach.
+ * @param high_water Largest content kept before flushing, or 0 for SB_BUFFER_SINK_HIGH_WATER.
+ * @return int 1 on success, 0 on failure (flush or memory allocation failed, or invalid input).
+ */
+int sb_buffer_set_sink(SB_Buffer *b, SB_Sink *sink, size_t high_water);
+
+/*!
+ * @brief Writes the content to the sink and empties the buffer.
+ * @param b Pointer to the Buffer structure.
+ * @return int 1 on success (or without a sink), 0 if the sink failed (the content is kept).
+ */
+int sb_buffer_flush(SB_Buffer *b);
+
+/* --- Editing --- */
+
+/*!
+ * @brief Removes the first n bytes of the content.
+ *
+ * On a heap block this only advances str (the consumed bytes become a head
+ * offset): no data moves, so draining a receive buffer piece by piece stays
+ * O(1) per call. The head is reclaimed lazily, when growth would otherwise
+ * be needed and moving the content costs no more than was consumed, and
+ * whenever the buffer is emptied. Inline content is moved down directly.
+ * @param b Pointer to the Buffer structure.
+ * @param n Number of bytes to drop (the whole content if n >= len).
+ * @return int 1 on success, 0 if the pointer is invalid.
+ */
+int sb_buffer_consume(SB_Buffer *b, size_t n);
+
+/*!
+ * @brief Inserts len bytes at offset pos.
+ *
+ * Moves only the shorter side of the content: the bytes before pos go down
+ * into the consumed head when it has room, otherwise the tail moves up.
+ * @param b Pointer to the Buffer structure.
+ * @param pos Insertion offset (0 to len).
+ * @param s Bytes to insert (must not point into the buffer).
+ * @param len Number of bytes to insert.
+ * @return int 1 on success, 0 on failure (pos past the end, memory allocation failed or invalid input).
+ */
+int sb_buffer_insert(SB_Buffer *b, size_t pos, const char *s, size_t len);
+
+/*!
+ * @brief Inserts len bytes at the front; O(len) when the head has room.
+ * @param b Pointer to the Buffer structure.
+ * @param s Bytes to insert (must not point into the buffer).
+ * @param len Number of bytes to insert.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_prepend(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Removes n bytes starting at offset pos.
+ *
+ * Moves only the shorter side: on a heap block the bytes before pos can
+ * slide up into the head instead of the tail sliding down.
+ * @param b Pointer to the Buffer structure.
+ * @param pos First offset to remove (0 to len).
+ * @param n Number of bytes to remove (clamped; SB_BUFFER_NPOS removes up to the end).
+ * @return int 1 on success, 0 if pos is past the end or the pointer is invalid.
+ */
+int sb_buffer_erase(SB_Buffer *b, size_t pos, size_t n);
+
+/*!
+ * @brief Moves the content back to the start of its storage, reclaiming the head.
+ * @param b Pointer to the Buffer structure.
+ * @return int 1 on success, 0 if the pointer is invalid.
+ */
+int sb_buffer_compact(SB_Buffer *b);
+
 /*!
  * @brief Resets the buffer to the initial stack state, freeing any heap memory.
  *
@@ -111,6 +554,9 @@ int sb_buffer_clear(SB_Buffer *b);
 
 /**
  * @brief Copies the content from the source buffer to the destination buffer.
+ *
+ * The existing capacity of dest is reused: copying into the same destination
+ * in a loop only allocates when the source outgrows it.
  * @note This function guarantees that the destination buffer will be an independent copy.
  * @param src Pointer to the source SB_Buffer (must be initialized).
  * @param dest Pointer to the destination SB_Buffer (must be initialized).
@@ -118,6 +564,19 @@ int sb_buffer_clear(SB_Buffer *b);
  */
 int sb_buffer_copy(SB_Buffer *src, SB_Buffer *dest);
 
+/**
+ * @brief Moves the content from the source buffer to the destination buffer.
+ *
+ * When src lives on the heap, its block (and the allocator that owns it) is
+ * handed to dest in O(1); otherwise the inline content is copied. Either way
+ * src is left empty and valid. Use this instead of struct assignment, which
+ * would leave str pointing into the other buffer's init array.
+ * @param src Pointer to the source SB_Buffer (must be initialized).
+ * @param dest Pointer to the destination SB_Buffer (must be initialized).
+ * @return int 1 on success, 0 on memory allocation failure or invalid input.
+ */
+int sb_buffer_move(SB_Buffer *src, SB_Buffer *dest);
+
 
 /*!
  * @brief Returns the current length of the string content in the buffer.
@@ -126,9 +585,23 @@ int sb_buffer_copy(SB_Buffer *src, SB_Buffer *dest);
  */
 size_t sb_buffer_get_len(SB_Buffer *b);
 
+/*!
+ * @brief Reports an invalid buffer pointer on stderr (kept out of line).
+ * @param file Source file of the failed check.
+ * @param line Source line of the failed check.
+ */
+SB_BUFFER_COLD void sb_buffer_report_invalid(const char *file, int line);
+
 
 /* --- Convenience Macros --- */
 
+/*
+ * Build mode switch: define SB_BUFFER_UNCHECKED (e.g. -DSB_BUFFER_UNCHECKED in
+ * release builds) to compile out the magic number validation below, used by
+ * every API call, and to route sb_buffer_add_string / sb_buffer_add_literal
+ * through the inline fast path.
+ */
+
 /**
  * @brief Safety macro that verifies if the pointer is valid (not NULL) and if the struct has been initialized
  * by checking its magic number.
@@ -137,22 +610,92 @@ size_t sb_buffer_get_len(SB_Buffer *b);
  * (int)  -->  CHECK_SB_BUFFER_POINTER_RET(b, 0);
  * (Ptr)  -->  CHECK_SB_BUFFER_POINTER_RET(b, NULL); 
  */
+#ifndef SB_BUFFER_UNCHECKED
 #define CHECK_SB_BUFFER_POINTER_RET(b, ret) \
     do { \
         if ( (b) == NULL || (b)->magic != SB_BUFFER_MAGIC) { \
-            /* In production, consider removing fprintf(stderr, ...) for extreme speed */ \
-            fprintf(stderr, "SB_Buffer Error: Invalid or uninitialized buffer pointer. File: %s, Line: %d\n", __FILE__, __LINE__); \
+            sb_buffer_report_invalid(__FILE__, __LINE__); \
             return ret; \
         } \
     } while(0)
-    
+#else
+#define CHECK_SB_BUFFER_POINTER_RET(b, ret) do { } while(0)
+#endif
+
+
+/* --- Inline Fast Path (no magic validation) --- */
+
+/*!
+ * @brief Inline append: a compare, a memcpy and a store when the data fits.
+ *
+ * The caller guarantees that b is a valid, initialized buffer. Growth is
+ * delegated to the out-of-line sb_buffer_add_lstring_slow().
+ * @param b Pointer to a valid Buffer structure.
+ * @param s Pointer to the source string.
+ * @param len Length of the source string to append.
+ * @return int 1 on success, 0 on memory allocation failure.
+ */
+SB_BUFFER_INLINE int sb_buffer_add_lstring_fast(SB_Buffer *b, const char *s, size_t len) {
+    if (SB_BUFFER_LIKELY(len < b->cap - b->len)) {
+        memcpy(b->str + b->len, s, len);
+        b->len += len;
+        b->str[b->len] = '\0';
+        b->hash = 0;
+        return 1;
+    }
+    return sb_buffer_add_lstring_slow(b, s, len);
+}
+
+/*!
+ * @brief Inline binary-mode append: a compare and a memcpy, no terminator store.
+ *
+ * Same contract as sb_buffer_add_lstring_fast(), for buffers in binary mode
+ * only (see sb_buffer_set_binary); the data may fill the capacity exactly.
+ * @param b Pointer to a valid Buffer structure in binary mode.
+ * @param s Pointer to the source bytes.
+ * @param len Number of bytes to append.
+ * @return int 1 on success, 0 on memory allocation failure.
+ */
+SB_BUFFER_INLINE int sb_buffer_add_data_fast(SB_Buffer *b, const char *s, size_t len) {
+    if (SB_BUFFER_LIKELY(len <= b->cap - b->len)) {
+        memcpy(b->str + b->len, s, len);
+        b->len += len;
+        b->hash = 0;
+        return 1;
+    }
+    return sb_buffer_add_lstring_slow(b, s, len);
+}
+
+/*!
+ * @brief Inline accessor for the raw C string (no magic validation).
+ *
+ * Not terminated in binary mode: use sb_buffer_get_str() there.
+ * @param b Pointer to a valid Buffer structure.
+ */
+SB_BUFFER_INLINE const char *sb_buffer_get_str_fast(const SB_Buffer *b) {
+    return b->str;
+}
+
+/*!
+ * @brief Inline accessor for the content length (no magic validation).
+ * @param b Pointer to a valid Buffer structure.
+ */
+SB_BUFFER_INLINE size_t sb_buffer_get_len_fast(const SB_Buffer *b) {
+    return b->len;
+}
+
+
 
 /*!
  * @brief Adds a null-terminated string (calculates length via strlen).
  * @param b The Buffer pointer.
  * @param s The null-terminated string pointer.
  */
+#ifndef SB_BUFFER_UNCHECKED
 #define sb_buffer_add_string(b, s) sb_buffer_add_lstring(b, s, strlen(s))
+#else
+#define sb_buffer_add_string(b, s) sb_buffer_add_lstring_fast(b, s, strlen(s))
+#endif
 
 /*!
  * @brief Adds a string literal (calculates length via sizeof at compile time).
@@ -160,7 +703,19 @@ size_t sb_buffer_get_len(SB_Buffer *b);
  * @param b The Buffer pointer.
  * @param literal The string literal.
  */
+#ifndef SB_BUFFER_UNCHECKED
 #define sb_buffer_add_literal(b, literal) sb_buffer_add_lstring(b, literal, (sizeof(literal)-1))
+#else
+#define sb_buffer_add_literal(b, literal) sb_buffer_add_lstring_fast(b, literal, (sizeof(literal)-1))
+#endif
+
+/*!
+ * @brief SB_Slice initializers for sb_buffer_add_many().
+ * e.g. SB_Slice parts[] = { SB_SLICE_LIT("GET "), SB_SLICE(path, path_len), SB_SLICE_STR(proto) };
+ */
+#define SB_SLICE(p, n) { (p), (n) }
+#define SB_SLICE_STR(s) { (s), strlen(s) }
+#define SB_SLICE_LIT(literal) { (literal), (sizeof(literal)-1) }
 
 /* Help to create and initialize the SB_Buffer
  * eg. SB_Buffer SB_INIT(b);   
@@ -172,6 +727,14 @@ size_t sb_buffer_get_len(SB_Buffer *b);
 #define SB_INIT(b) b;\
    sb_buffer_init((&b))
 
+/*!
+ * @brief Initializes any buffer type declared with SB_BUFFER_DEFINE.
+ * e.g. SB_Buffer16 b; SB_BUFFER_INIT_SIZED(&b);
+ * @param p Pointer to the typed buffer.
+ */
+#define SB_BUFFER_INIT_SIZED(p) \
+    sb_buffer_init_inline(SB_BUFFER_AS(p), sizeof((p)->init))
+
 
 /* Close C++ compatibility wrapper */
 #ifdef __cplusplus
@@ -0,0 +1,394 @@
+/*!
+ * @file sb_buffer.hpp
+ * @brief Header-only C++17 RAII wrapper around SB_Buffer.
+ *
+ * sb::buffer<N, Alloc> owns an SB_Buffer with N bytes of inline storage.
+ * The destructor finalizes it, copies are deep, and moves steal the heap
+ * block in O(1) (noexcept, so std::vector relocates instead of copying).
+ * Appends go through the inline fast path; string literal lengths are
+ * resolved at compile time, like sb_buffer_add_literal.
+ *
+ * Alloc selects the heap storage: sb::default_allocator uses the library
+ * default (see sb_buffer_set_default_allocator), any stateless standard
+ * allocator (e.g. std::allocator<char>) is bridged to an SB_Allocator.
+ * Allocation failures throw std::bad_alloc.
+ *
+ * append(a, b, c...) builds a line from several pieces (literals, strings,
+ * chars, integers) with one capacity check: the space needed is bounded
+ * from the argument types (exact for literals), then every piece is copied
+ * with its own straight-line code. sb::concat() joins string literals at
+ * compile time into a single constant, e.g. fixed response headers.
+ */
+#ifndef SB_BUFFER_HPP
+#define SB_BUFFER_HPP
+
+#include "sb_buffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace sb {
+
+/*! @brief Allocator tag: the buffer uses the library default allocator. */
+struct default_allocator {};
+
+/*!
+ * @struct literal
+ * @brief K bytes of text known at compile time (plus the terminator).
+ *
+ * Produced by sb::concat(); appending one is a single constant-size copy.
+ */
+template <std::size_t K>
+struct literal {
+    char data[K + 1];
+
+    static constexpr std::size_t size() noexcept { return K; }
+    constexpr const char *c_str() const noexcept { return data; }
+    constexpr operator std::string_view() const noexcept { return std::string_view(data, K); }
+};
+
+/*!
+ * @brief Joins string literals at compile time.
+ * e.g. static constexpr auto ok = sb::concat("HTTP/1.1 200 OK\r\n", "Content-Type: text/html\r\n");
+ */
+template <std::size_t... M>
+constexpr literal<(std::size_t{0} + ... + (M - 1))> concat(const char (&... parts)[M]) noexcept {
+    literal<(std::size_t{0} + ... + (M - 1))> out{};
+    std::size_t pos = 0;
+    auto put = [&out, &pos](const char *s, std::size_t n) constexpr {
+        for (std::size_t i = 0; i < n; i++) out.data[pos++] = s[i];
+    };
+
+    (put(parts, M - 1), ...);
+    out.data[pos] = '\0';
+    return out;
+}
+
+namespace detail {
+
+/* Bridges a stateless standard allocator to the SB_Allocator vtable */
+template <class Alloc>
+struct allocator_bridge {
+    using char_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<char>;
+    using traits = std::allocator_traits<char_alloc>;
+
+    static_assert(traits::is_always_equal::value, "sb::buffer needs a stateless allocator");
+
+    /* Called from C: exceptions are turned into NULL */
+    static void *alloc_fn(void *, size_t size) noexcept {
+        char_alloc a;
+        try { return traits::allocate(a, size); } catch (...) { return nullptr; }
+    }
+
+    static void *realloc_fn(void *ctx, void *ptr, size_t old_size, size_t new_size) noexcept {
+        char *p = static_cast<char*>(alloc_fn(ctx, new_size));
+        if (!p) return nullptr;
+        std::memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+        free_fn(ctx, ptr, old_size);
+        return p;
+    }
+
+    static void free_fn(void *, void *ptr, size_t size) noexcept {
+        char_alloc a;
+        traits::deallocate(a, static_cast<char*>(ptr), size);
+    }
+
+    static const SB_Allocator *get() noexcept {
+        static const SB_Allocator table = { alloc_fn, realloc_fn, free_fn, nullptr };
+        return &table;
+    }
+};
+
+template <>
+struct allocator_bridge<default_allocator> {
+    static const SB_Allocator *get() noexcept { return nullptr; } /* Keep what sb_buffer_init picked */
+};
+
+/*
+ * Pieces of buffer::append(): piece_size() bounds the bytes a piece needs
+ * (a constant for literals and integers), piece_write() copies it and
+ * returns the end of what it wrote.
+ */
+
+/* String literal (or const char array holding one): sizeof - 1, like sb_buffer_add_literal */
+template <std::size_t M>
+constexpr std::size_t piece_size(const char (&)[M]) noexcept { return M - 1; }
+template <std::size_t M>
+inline char *piece_write(char *p, const char (&s)[M]) noexcept {
+    std::memcpy(p, s, M - 1);
+    return p + (M - 1);
+}
+
+/* Writable char array: a C string of unknown length */
+template <std::size_t M>
+inline std::size_t piece_size(char (&s)[M]) noexcept { return std::strlen(s); }
+template <std::size_t M>
+inline char *piece_write(char *p, char (&s)[M]) noexcept {
+    std::size_t n = std::strlen(s);
+    std::memcpy(p, s, n);
+    return p + n;
+}
+
+template <std::size_t K>
+constexpr std::size_t piece_size(const literal<K> &) noexcept { return K; }
+template <std::size_t K>
+inline char *piece_write(char *p, const literal<K> &s) noexcept {
+    std::memcpy(p, s.data, K);
+    return p + K;
+}
+
+/* Anything viewable as a string: std::string, const char *, sb::buffer... */
+inline std::size_t piece_size(std::string_view s) noexcept { return s.size(); }
+inline char *piece_write(char *p, std::string_view s) noexcept {
+    std::memcpy(p, s.data(), s.size());
+    return p + s.size();
+}
+
+constexpr std::size_t piece_size(char) noexcept { return 1; }
+inline char *piece_write(char *p, char c) noexcept {
+    *p = c;
+    return p + 1;
+}
+
+/* bool would silently become a char */
+template <class T, std::enable_if_t<std::is_same_v<T, bool>, int> = 0>
+void piece_size(T) = delete;
+
+template <class T>
+using if_number = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>, int>;
+
+/* "00" "01" ... "99" */
+inline constexpr char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+inline char *write_u64(char *p, std::uint64_t v) noexcept {
+    std::size_t n = 1;
+    char *end;
+
+    for (std::uint64_t t = v; t >= 10; t /= 10) n++;
+    end = p + n;
+    while (v >= 100) {
+        end -= 2;
+        std::memcpy(end, digit_pairs + (v % 100) * 2, 2);
+        v /= 100;
+    }
+    if (v >= 10) std::memcpy(end - 2, digit_pairs + v * 2, 2);
+    else end[-1] = (char)('0' + v);
+    return p + n;
+}
+
+/* Decimal integer: at most digits10 + 1 digits and a sign */
+template <class T, if_number<T> = 0>
+constexpr std::size_t piece_size(T) noexcept { return (std::size_t)std::numeric_limits<T>::digits10 + 2; }
+template <class T, if_number<T> = 0>
+inline char *piece_write(char *p, T v) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+        if (v < 0) {
+            *p++ = '-';
+            return write_u64(p, (std::uint64_t)0 - (std::uint64_t)v);
+        }
+    }
+    return write_u64(p, (std::uint64_t)v);
+}
+
+/* append(pointer, length) keeps its meaning: the variadic form stays out of it */
+template <class... Args>
+struct is_pointer_length : std::false_type {};
+template <class P, class L>
+struct is_pointer_length<P, L> : std::bool_constant<
+    std::is_pointer_v<std::decay_t<P>> && std::is_integral_v<std::decay_t<L>> &&
+    !std::is_same_v<std::decay_t<L>, char> && !std::is_same_v<std::decay_t<L>, bool>> {};
+
+} /* namespace detail */
+
+/*!
+ * @class buffer
+ * @brief Owning string buffer with N bytes of inline (SSO) storage.
+ * @tparam N Inline capacity, including the terminator (at least 1).
+ * @tparam Alloc sb::default_allocator or a stateless standard allocator.
+ */
+template <std::size_t N = SB_BUFFER_INITIAL_CAP, class Alloc = default_allocator>
+class buffer {
+    static_assert(N >= 1, "the inline storage must hold the terminator");
+
+    SB_BUFFER_DEFINE(storage, N);
+    storage b_;
+
+    void init() noexcept {
+        sb_buffer_init_inline(raw(), N);
+        if (const SB_Allocator *a = detail::allocator_bridge<Alloc>::get()) b_.alloc = a; /* Still inline: nothing to move */
+    }
+
+    void release() noexcept {
+        if (b_.str != b_.init) b_.alloc->free_fn(b_.alloc->ctx, b_.str - b_.head, b_.cap + b_.head);
+    }
+
+    /* sb_buffer_move() inlined: both sides are valid and share the inline capacity N */
+    void steal(buffer &other) noexcept {
+        if (other.b_.str != other.b_.init) {
+            release();
+            b_.str = other.b_.str;
+            b_.cap = other.b_.cap;
+            b_.head = other.b_.head;
+            b_.alloc = other.b_.alloc;
+            other.b_.str = other.b_.init;
+            other.b_.cap = N;
+            other.b_.head = 0;
+        } else {
+            /* Fits: with the head reclaimed our capacity is at least N */
+            b_.str -= b_.head;
+            b_.cap += b_.head;
+            b_.head = 0;
+            std::memcpy(b_.str, other.b_.str, other.b_.len + SB_BUFFER_TAIL(&other.b_));
+        }
+        b_.flags = (b_.flags & ~std::uint32_t{SB_BUFFER_BINARY}) | (other.b_.flags & SB_BUFFER_BINARY);
+        b_.len = other.b_.len;
+        b_.hash = other.b_.hash;
+        other.b_.len = 0;
+        other.b_.hash = 0;
+        other.b_.str[0] = '\0';
+    }
+
+    static void check(int ok) {
+        if (!ok) throw std::bad_alloc();
+    }
+
+public:
+    /*! @brief Inline capacity of this buffer type. */
+    static constexpr std::size_t inline_capacity = N;
+
+    buffer() noexcept { init(); }
+
+    /*! @brief Builds a buffer holding a copy of s. */
+    explicit buffer(std::string_view s) : buffer() { append(s.data(), s.size()); }
+
+    buffer(const buffer &other) : buffer() { append(other.data(), other.size()); }
+
+    /*! @brief Takes the heap block of other in O(1); other is left empty. */
+    buffer(buffer &&other) noexcept : buffer() { steal(other); }
+
+    buffer &operator=(const buffer &other) {
+        if (this != &other) check(sb_buffer_copy(const_cast<buffer&>(other).raw(), raw()));
+        return *this;
+    }
+
+    buffer &operator=(buffer &&other) noexcept {
+        if (this != &other) steal(other);
+        return *this;
+    }
+
+    buffer &operator=(std::string_view s) {
+        clear();
+        return append(s.data(), s.size());
+    }
+
+    ~buffer() { release(); }
+
+    /* --- C interop --- */
+
+    /*! @brief The underlying buffer, for the C API (e.g. sb_buffer_appendf). */
+    SB_Buffer *raw() noexcept { return SB_BUFFER_AS(&b_); }
+    const SB_Buffer *raw() const noexcept { return reinterpret_cast<const SB_Buffer*>(&b_); }
+
+    /* --- Accessors --- */
+
+    const char *data() const noexcept { return b_.str; }
+    char *data() noexcept { return b_.str; }
+    const char *c_str() const noexcept { return b_.str; }
+    std::size_t size() const noexcept { return b_.len; }
+    std::size_t length() const noexcept { return b_.len; }
+    /*! @brief Largest content that fits without growing. */
+    std::size_t capacity() const noexcept { return b_.cap - SB_BUFFER_TAIL(&b_); }
+    bool empty() const noexcept { return b_.len == 0; }
+
+    const char *begin() const noexcept { return b_.str; }
+    const char *end() const noexcept { return b_.str + b_.len; }
+    char operator[](std::size_t i) const noexcept { return b_.str[i]; }
+
+    std::string_view view() const noexcept { return std::string_view(b_.str, b_.len); }
+    operator std::string_view() const noexcept { return view(); }
+
+    /* --- Capacity --- */
+
+    void reserve(std::size_t n) { check(sb_buffer_reserve(raw(), n)); }
+    void shrink_to_fit() { check(sb_buffer_shrink_to_fit(raw())); }
+    /*! @brief Empties the buffer, keeping its capacity. */
+    void clear() noexcept { sb_buffer_clear(raw()); }
+    /*! @brief Empties the buffer and releases its heap block. */
+    void reset() noexcept { sb_buffer_reset(raw()); }
+
+    /* --- Editing --- */
+
+    /*! @brief Drops the first n bytes (O(1) on a heap block). */
+    void consume(std::size_t n) noexcept { sb_buffer_consume(raw(), n); }
+    void erase(std::size_t pos, std::size_t n = SB_BUFFER_NPOS) noexcept { sb_buffer_erase(raw(), pos, n); }
+    void insert(std::size_t pos, std::string_view s) {
+        if (pos > size()) throw std::out_of_range("sb::buffer::insert");
+        check(sb_buffer_insert(raw(), pos, s.data(), s.size()));
+    }
+    void prepend(std::string_view s) { check(sb_buffer_prepend(raw(), s.data(), s.size())); }
+
+    /* --- Appends --- */
+
+    buffer &append(const char *s, std::size_t len) {
+        check(sb_buffer_add_lstring_fast(raw(), s, len));
+        return *this;
+    }
+
+    buffer &append(std::string_view s) { return append(s.data(), s.size()); }
+
+    /*!
+     * @brief Appends every argument with a single capacity check.
+     *
+     * Accepts string literals, sb::literal, strings (anything convertible to
+     * std::string_view), chars and integers. The room is bounded up front
+     * (a compile-time constant when the pieces are literals and numbers),
+     * reserved once, and each piece is copied in turn without further checks.
+     */
+    template <class... Args, std::enable_if_t<(sizeof...(Args) > 0) && !detail::is_pointer_length<Args...>::value, int> = 0>
+    buffer &append(Args &&... args) {
+        const std::size_t bound = (std::size_t{0} + ... + detail::piece_size(args));
+        char *p = SB_BUFFER_LIKELY(bound <= SB_BUFFER_ROOM(&b_)) ? b_.str + b_.len : sb_buffer_prepare(raw(), bound);
+        char *end = p;
+
+        if (!p) throw std::bad_alloc();
+        ((end = detail::piece_write(end, args)), ...);
+        b_.len += (std::size_t)(end - p);
+        SB_BUFFER_TERMINATE(&b_);
+        b_.hash = 0;
+        return *this;
+    }
+
+    /*! @brief String literal: the length is a compile-time constant. */
+    template <std::size_t M>
+    buffer &operator+=(const char (&literal)[M]) { return append(literal, M - 1); }
+
+    /*! @brief Writable char array: holds a C string of unknown length. */
+    template <std::size_t M>
+    buffer &operator+=(char (&s)[M]) { return append(s, std::strlen(s)); }
+
+    template <std::size_t K>
+    buffer &operator+=(const literal<K> &s) { return append(s.data, K); }
+
+    buffer &operator+=(std::string_view s) { return append(s.data(), s.size()); }
+
+    buffer &operator+=(char c) { return append(&c, 1); }
+
+    /* --- Comparison --- */
+
+    friend bool operator==(const buffer &a, std::string_view b) noexcept { return a.view() == b; }
+    friend bool operator!=(const buffer &a, std::string_view b) noexcept { return a.view() != b; }
+};
+
+} /* namespace sb */
+
+#endif /* SB_BUFFER_HPP */
@@ -0,0 +1,59 @@
+/*!
+ * @file sb_build.h
+ * @brief Parallel bulk building of one SB_Buffer from many records.
+ *
+ * sb_buffer_build_parallel() splits a record range [0, count) into one
+ * contiguous slice per thread. Every thread formats its slice into a private
+ * buffer with the regular API (no locks, no shared state); the calling
+ * thread formats the first slice straight into the destination. A prefix
+ * sum over the piece lengths then gives each piece its offset, the
+ * destination is sized once with sb_buffer_reserve(), and the threads copy
+ * their pieces into place concurrently. The output is identical to formatting the range
+ * in order on one thread. Requires POSIX threads.
+ */
+#ifndef SB_BUILD_H
+#define SB_BUILD_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Largest number of threads used by one build. */
+#define SB_BUILD_MAX_THREADS 256
+
+/*!
+ * @brief Formats the records [begin, end) by appending them to out.
+ *
+ * Called once per slice, concurrently from several threads: it may only
+ * share read-only state through ctx.
+ * @return int 1 on success, 0 to abort the build.
+ */
+typedef int (*SB_BuildFn)(void *ctx, SB_Buffer *out, size_t begin, size_t end);
+
+/*!
+ * @brief Appends the records [0, count) to dest, formatting them on several threads.
+ *
+ * On failure (a callback returned 0, or memory allocation failed) the
+ * content of dest is left as it was. A sink-backed destination receives the
+ * pieces in order through the regular append instead (flushing as usual,
+ * so a failure there may leave part of the output written).
+ * The per-thread pieces always use sb_buffer_malloc_allocator, whatever the
+ * default allocator is; only dest uses its own, from the calling thread.
+ * @param dest Pointer to the destination Buffer structure.
+ * @param count Number of records.
+ * @param threads Number of threads including the caller, or 0 for one per online CPU.
+ * @param fn Record formatter.
+ * @param ctx Passed to fn.
+ * @return int 1 on success, 0 on failure (see above, or invalid input).
+ */
+int sb_buffer_build_parallel(SB_Buffer *dest, size_t count, unsigned threads, SB_BuildFn fn, void *ctx);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_BUILD_H */
@@ -0,0 +1,75 @@
+/*!
+ * @file sb_codec.h
+ * @brief Hex and base64 encoding/decoding directly into an SB_Buffer.
+ *
+ * Every function reserves the exact output size once and writes straight
+ * into the spare capacity: no intermediate storage is allocated. Hex uses
+ * SSE2/NEON kernels, base64 encoding an SSSE3 kernel when the CPU has it;
+ * the remaining paths are table driven.
+ *
+ * To decode the content of another buffer, pass src->str and src->len.
+ */
+#ifndef SB_CODEC_H
+#define SB_CODEC_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Appends the lowercase hex encoding of data (2 * len characters).
+ * @param b Pointer to the Buffer structure.
+ * @param data Bytes to encode.
+ * @param len Number of bytes.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_hex(SB_Buffer *b, const void *data, size_t len);
+
+/*!
+ * @brief Decodes hex text (either case) and appends the bytes.
+ * @param b Pointer to the Buffer structure.
+ * @param s Hex text.
+ * @param len Length of the text (must be even).
+ * @return int 1 on success, 0 on invalid text (the buffer is left unchanged) or failure.
+ */
+int sb_buffer_add_hex_decoded(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Appends the standard base64 encoding of data (RFC 4648, with '=' padding).
+ * @param b Pointer to the Buffer structure.
+ * @param data Bytes to encode.
+ * @param len Number of bytes.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_base64(SB_Buffer *b, const void *data, size_t len);
+
+/*!
+ * @brief Appends the URL-safe base64 encoding of data ('-' and '_', no padding).
+ * @param b Pointer to the Buffer structure.
+ * @param data Bytes to encode.
+ * @param len Number of bytes.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_base64url(SB_Buffer *b, const void *data, size_t len);
+
+/*!
+ * @brief Decodes base64 text and appends the bytes.
+ *
+ * Accepts both the standard and the URL-safe alphabets, with or without
+ * trailing '=' padding. Whitespace is not allowed.
+ * @param b Pointer to the Buffer structure.
+ * @param s Base64 text.
+ * @param len Length of the text.
+ * @return int 1 on success, 0 on invalid text (the buffer is left unchanged) or failure.
+ */
+int sb_buffer_add_base64_decoded(SB_Buffer *b, const char *s, size_t len);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_CODEC_H */
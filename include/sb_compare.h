@@ -0,0 +1,112 @@
+/*!
+ * @file sb_compare.h
+ * @brief Length-aware equality, ordering and prefix tests over SB_Buffer contents.
+ *
+ * Every test uses the tracked length instead of scanning for the
+ * terminator: equality rejects on length (and on cached hashes, see
+ * sb_hash.h) before touching the bytes. Keys of up to 16 bytes are compared
+ * with a few overlapping word loads, longer ones with SSE2/NEON vectors
+ * (case-insensitive) or the vectorized libc memcmp. The case-insensitive
+ * variants fold ASCII letters only, which is what HTTP header names need.
+ */
+#ifndef SB_COMPARE_H
+#define SB_COMPARE_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Raw memory kernels --- */
+
+/*!
+ * @brief Tests n bytes for equality.
+ * @return int 1 if p[0..n) and q[0..n) are equal, 0 otherwise.
+ */
+int sb_mem_equal(const char *p, const char *q, size_t n);
+
+/*!
+ * @brief Tests n bytes for equality, ignoring ASCII case.
+ * @return int 1 if p[0..n) and q[0..n) are equal once 'A'-'Z' are folded to 'a'-'z', 0 otherwise.
+ */
+int sb_mem_equal_icase(const char *p, const char *q, size_t n);
+
+/* --- Buffer API --- */
+
+/*!
+ * @brief Tests two buffers for equal content.
+ * @param a Pointer to the first Buffer structure.
+ * @param b Pointer to the second Buffer structure.
+ * @return int 1 if the contents are equal, 0 if not (or if a pointer is invalid).
+ */
+int sb_buffer_equals(SB_Buffer *a, SB_Buffer *b);
+
+/*!
+ * @brief Tests the buffer content against s[0..len).
+ * @param b Pointer to the Buffer structure.
+ * @param s Bytes to compare with.
+ * @param len Length of s.
+ * @return int 1 if equal, 0 if not (or on invalid input).
+ */
+int sb_buffer_equals_lstring(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Tests the buffer content against s[0..len), ignoring ASCII case.
+ * @param b Pointer to the Buffer structure.
+ * @param s Bytes to compare with.
+ * @param len Length of s.
+ * @return int 1 if equal, 0 if not (or on invalid input).
+ */
+int sb_buffer_equals_icase(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Orders two buffers like memcmp, a shorter prefix first.
+ * @param a Pointer to the first Buffer structure.
+ * @param b Pointer to the second Buffer structure.
+ * @return int Negative, zero or positive as a sorts before, equal to or after b (0 if a pointer is invalid).
+ */
+int sb_buffer_compare(SB_Buffer *a, SB_Buffer *b);
+
+/*!
+ * @brief Orders two buffers ignoring ASCII case (as if both were lowercase).
+ * @param a Pointer to the first Buffer structure.
+ * @param b Pointer to the second Buffer structure.
+ * @return int Negative, zero or positive as a sorts before, equal to or after b (0 if a pointer is invalid).
+ */
+int sb_buffer_compare_icase(SB_Buffer *a, SB_Buffer *b);
+
+/*!
+ * @brief Tests whether the content starts with s[0..len).
+ * @return int 1 if it does, 0 if not (or on invalid input).
+ */
+int sb_buffer_starts_with(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Tests whether the content starts with s[0..len), ignoring ASCII case.
+ * @return int 1 if it does, 0 if not (or on invalid input).
+ */
+int sb_buffer_starts_with_icase(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Tests whether the content ends with s[0..len).
+ * @return int 1 if it does, 0 if not (or on invalid input).
+ */
+int sb_buffer_ends_with(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Literal forms (length computed at compile time).
+ * e.g. if (sb_buffer_equals_icase_literal(&name, "content-length")) ...
+ */
+#define sb_buffer_equals_literal(b, literal) sb_buffer_equals_lstring(b, literal, (sizeof(literal)-1))
+#define sb_buffer_equals_icase_literal(b, literal) sb_buffer_equals_icase(b, literal, (sizeof(literal)-1))
+#define sb_buffer_starts_with_literal(b, literal) sb_buffer_starts_with(b, literal, (sizeof(literal)-1))
+#define sb_buffer_ends_with_literal(b, literal) sb_buffer_ends_with(b, literal, (sizeof(literal)-1))
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_COMPARE_H */
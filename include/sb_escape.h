@@ -0,0 +1,62 @@
+/*!
+ * @file sb_escape.h
+ * @brief Escape-on-append for JSON, HTML and CSV output.
+ *
+ * The input is scanned 16/32 bytes at a time (SIMD kernels, see sb_search.h)
+ * for bytes that need escaping; clean runs are bulk-copied straight into the
+ * buffer's spare capacity. Room is reserved up front, so each call grows the
+ * buffer at most once: the worst case when it already fits in the spare
+ * capacity, otherwise the exact size, measured with the same scanner, so that
+ * mostly clean text does not grow the buffer to six times its length.
+ */
+#ifndef SB_ESCAPE_H
+#define SB_ESCAPE_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Appends s escaped for use inside a JSON string (quotes not added).
+ *
+ * Escapes '"', '\\' and control bytes (\\n \\r \\t \\b \\f, otherwise \\u00XX).
+ * Other bytes, including UTF-8 sequences, are copied unchanged.
+ * @param b Pointer to the Buffer structure.
+ * @param s Source data.
+ * @param len Length of the source data.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_json_escaped(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Appends s escaped for HTML text and attribute values.
+ *
+ * Replaces & < > " ' with &amp; &lt; &gt; &quot; &#39;.
+ * @param b Pointer to the Buffer structure.
+ * @param s Source data.
+ * @param len Length of the source data.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_html_escaped(SB_Buffer *b, const char *s, size_t len);
+
+/*!
+ * @brief Appends s as a CSV field (RFC 4180).
+ *
+ * The field is enclosed in double quotes, with embedded quotes doubled, when
+ * it contains a comma, a double quote, CR or LF; otherwise it is copied as is.
+ * @param b Pointer to the Buffer structure.
+ * @param s Source data.
+ * @param len Length of the source data.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_add_csv_quoted(SB_Buffer *b, const char *s, size_t len);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_ESCAPE_H */
@@ -0,0 +1,139 @@
+/*!
+ * @file sb_hash.h
+ * @brief Fast non-cryptographic hashing of buffer contents and a string interning table.
+ *
+ * The hash is a wyhash-style kernel (64x64->128-bit multiply-mix over 16 and
+ * 48-byte blocks): a handful of cycles for short keys, several GB/s for
+ * long ones. Not suitable against hash flooding unless a secret seed is used,
+ * and not stable across byte orders.
+ *
+ * sb_buffer_hash() caches the result in the buffer; every library call that
+ * changes the content clears the cache. Code that writes into b->str directly
+ * (outside sb_buffer_prepare/sb_buffer_commit) must set b->hash to 0.
+ *
+ * SB_InternTable deduplicates strings and hands out dense, stable 32-bit IDs.
+ * It is an open-addressing table with linear probing whose slots keep the
+ * full hash and, for keys of up to SB_INTERN_INLINE bytes, the key itself:
+ * a lookup of a short string touches one slot and nothing else. The bytes of
+ * every string are copied once into arena chunks and stay put until the table
+ * is finalized.
+ */
+#ifndef SB_HASH_H
+#define SB_HASH_H
+
+#include "sb_buffer.h"
+#include "sb_arena.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Longest key compared inside the slot, without following a pointer. */
+#define SB_INTERN_INLINE 16
+
+/*! @brief ID returned when a string is not (or could not be) interned. */
+#define SB_INTERN_NONE ((uint32_t)-1)
+
+/*!
+ * @struct SB_InternSlot
+ * @brief One slot of the interning table (32 bytes: two per cache line).
+ */
+typedef struct {
+    uint64_t hash;                 /* Never 0 for a used slot; 0 marks an empty one */
+    uint32_t id;
+    uint32_t len;
+    char key[SB_INTERN_INLINE];    /* First bytes of the key (all of it when short) */
+} SB_InternSlot;
+
+/*!
+ * @struct SB_InternTable
+ * @brief Open-addressing string interning table.
+ */
+typedef struct {
+    SB_InternSlot *slots;
+    size_t mask;          /* Number of slots - 1 (a power of two) */
+    SB_Slice *strings;    /* Interned strings, indexed by ID */
+    uint32_t count;
+    uint32_t strings_cap;
+    SB_Arena arena;       /* Storage of the string bytes */
+    char *chunk;          /* Unused part of the current arena block */
+    size_t chunk_left;
+} SB_InternTable;
+
+/*!
+ * @brief Hashes len bytes with the given seed.
+ * @param p Bytes to hash (may be NULL when len is 0).
+ * @param len Number of bytes.
+ * @param seed Any value; a random secret seed protects against crafted collisions.
+ * @return uint64_t The hash.
+ */
+uint64_t sb_hash_bytes(const void *p, size_t len, uint64_t seed);
+
+/*!
+ * @brief Hashes the buffer content (seed 0), caching the result in the buffer.
+ *
+ * Computed once; repeated calls return the cached value until the content changes.
+ * @param b Pointer to the Buffer structure.
+ * @return uint64_t A non-zero hash, or 0 if the pointer is invalid.
+ */
+uint64_t sb_buffer_hash(SB_Buffer *b);
+
+/*!
+ * @brief Initializes an empty table.
+ * @param t Pointer to the table.
+ * @param expected Number of strings expected (sizes the slot array), or 0.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_intern_init(SB_InternTable *t, size_t expected);
+
+/*!
+ * @brief Returns the ID of a string, adding it if it is new.
+ *
+ * IDs are assigned densely (0, 1, 2, ...) in insertion order.
+ * @param t Pointer to the table.
+ * @param s Bytes of the string.
+ * @param len Length of the string (below 4 GiB).
+ * @return uint32_t The ID, or SB_INTERN_NONE on failure (memory allocation failed or invalid input).
+ */
+uint32_t sb_intern(SB_InternTable *t, const char *s, size_t len);
+
+/*!
+ * @brief sb_intern() for the content of a buffer, reusing its cached hash.
+ * @param t Pointer to the table.
+ * @param b Pointer to the Buffer structure.
+ * @return uint32_t The ID, or SB_INTERN_NONE on failure.
+ */
+uint32_t sb_intern_buffer(SB_InternTable *t, SB_Buffer *b);
+
+/*!
+ * @brief Looks a string up without adding it.
+ * @param t Pointer to the table.
+ * @param s Bytes of the string.
+ * @param len Length of the string.
+ * @return uint32_t The ID, or SB_INTERN_NONE if the string was never interned.
+ */
+uint32_t sb_intern_find(const SB_InternTable *t, const char *s, size_t len);
+
+/*!
+ * @brief Returns the string of an ID.
+ * @param t Pointer to the table.
+ * @param id ID returned by sb_intern().
+ * @param len Receives the length (may be NULL).
+ * @return const char* The null-terminated string (valid until sb_intern_finalize), or NULL for an unknown ID.
+ */
+const char *sb_intern_get(const SB_InternTable *t, uint32_t id, size_t *len);
+
+/*!
+ * @brief Releases the slots, the ID index and every interned string.
+ * @param t Pointer to the table.
+ * @return int 1 on success, 0 if the pointer is NULL.
+ */
+int sb_intern_finalize(SB_InternTable *t);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_HASH_H */
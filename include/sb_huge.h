@@ -0,0 +1,67 @@
+/*!
+ * @file sb_huge.h
+ * @brief Huge-page, NUMA-local backing for large heap buffers.
+ *
+ * SB_HugeAllocator is an SB_Allocator that leaves small blocks to malloc and
+ * maps blocks of threshold bytes or more directly: anonymous mappings rounded
+ * to SB_HUGE_PAGE_SIZE and aligned on it, marked MADV_HUGEPAGE (or explicit
+ * hugetlb pages with SB_HUGE_HUGETLB), optionally bound to the NUMA node of
+ * the thread that allocates them. A growing block is extended with mremap,
+ * which moves page table entries instead of copying the content.
+ *
+ * Whether a block is mapped follows from its size alone, so the threshold
+ * and flags must not change while buffers use the allocator. Linux only for
+ * huge pages, mremap and NUMA binding; elsewhere large blocks are plain
+ * mappings grown by copy.
+ */
+#ifndef SB_HUGE_H
+#define SB_HUGE_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Huge page size the mappings are rounded and aligned to. */
+#ifndef SB_HUGE_PAGE_SIZE
+#define SB_HUGE_PAGE_SIZE ((size_t)2 << 20)
+#endif
+
+/*! @brief Default threshold: one huge page (smaller blocks would mostly waste it). */
+#define SB_HUGE_DEFAULT_THRESHOLD SB_HUGE_PAGE_SIZE
+
+/*! @brief Binds the mapped blocks to the NUMA node of the allocating thread (mbind MPOL_BIND). */
+#define SB_HUGE_NUMA_LOCAL 0x1u
+
+/*! @brief Uses explicit hugetlb pages (MAP_HUGETLB), falling back to transparent huge pages. */
+#define SB_HUGE_HUGETLB 0x2u
+
+/*!
+ * @struct SB_HugeAllocator
+ * @brief Allocator vtable and settings for huge-page backed buffers.
+ */
+typedef struct {
+    SB_Allocator allocator; /* Vtable handed to buffers (ctx is this struct) */
+    size_t threshold;       /* Blocks of at least this size are mapped */
+    unsigned flags;         /* SB_HUGE_* */
+} SB_HugeAllocator;
+
+/*!
+ * @brief Sets up a huge-page allocator.
+ *
+ * e.g. sb_huge_allocator_init(&h, 0, SB_HUGE_NUMA_LOCAL); sb_buffer_set_allocator(&b, &h.allocator);
+ * @param h Allocator state (owned by the caller; must outlive the buffers using it).
+ * @param threshold Smallest block size to map, or 0 for SB_HUGE_DEFAULT_THRESHOLD.
+ * @param flags Combination of SB_HUGE_NUMA_LOCAL and SB_HUGE_HUGETLB, or 0.
+ * @return int 1 on success, 0 if h is NULL or flags holds unknown bits.
+ */
+int sb_huge_allocator_init(SB_HugeAllocator *h, size_t threshold, unsigned flags);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_HUGE_H */
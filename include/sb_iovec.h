@@ -0,0 +1,115 @@
+/*!
+ * @file sb_iovec.h
+ * @brief Scatter-gather output of SB_Buffer contents (writev/sendmsg helpers).
+ *
+ * A cursor walks a list of buffers, fills struct iovec arrays that point
+ * directly into their storage and advances over partial writes, so several
+ * buffers (headers, body, trailers) go out with one syscall and no copy.
+ * POSIX only.
+ */
+#ifndef SB_IOVEC_H
+#define SB_IOVEC_H
+
+#include "sb_buffer.h"
+#include <sys/types.h> /* For ssize_t */
+#include <sys/uio.h>   /* For struct iovec */
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Maximum number of iovec entries submitted per syscall. */
+#ifndef SB_IOVEC_BATCH
+#define SB_IOVEC_BATCH 64
+#endif
+
+/*!
+ * @struct SB_IovecCursor
+ * @brief Write position inside a list of buffers.
+ */
+typedef struct {
+    SB_Buffer *const *bufs; /* Buffers to send, in order */
+    size_t count;           /* Number of buffers */
+    size_t index;           /* Current buffer */
+    size_t offset;          /* Bytes of bufs[index] already written */
+} SB_IovecCursor;
+
+/*!
+ * @brief Fills an iovec array with the contents of a list of buffers.
+ *
+ * Empty buffers are skipped. The entries point into the buffers' storage and
+ * are valid until the buffers are modified.
+ * @param bufs Array of buffer pointers.
+ * @param count Number of buffers.
+ * @param iov Destination array.
+ * @param max_iov Capacity of iov.
+ * @return size_t Number of entries filled (0 on invalid input).
+ */
+size_t sb_buffer_fill_iovec(SB_Buffer *const *bufs, size_t count, struct iovec *iov, size_t max_iov);
+
+/*!
+ * @brief Positions a cursor at the start of a list of buffers.
+ * @param c Pointer to the cursor.
+ * @param bufs Array of buffer pointers (must stay valid while the cursor is used).
+ * @param count Number of buffers.
+ * @return int 1 on success, 0 on invalid input (NULL or uninitialized buffer).
+ */
+int sb_iovec_cursor_init(SB_IovecCursor *c, SB_Buffer *const *bufs, size_t count);
+
+/*!
+ * @brief Fills an iovec array with the data still to be written.
+ * @param c Pointer to the cursor.
+ * @param iov Destination array.
+ * @param max_iov Capacity of iov.
+ * @return size_t Number of entries filled (0 when everything was written).
+ */
+size_t sb_iovec_cursor_fill(SB_IovecCursor *c, struct iovec *iov, size_t max_iov);
+
+/*!
+ * @brief Moves the cursor forward after a (possibly partial) write.
+ * @param c Pointer to the cursor.
+ * @param written Number of bytes accepted by the kernel.
+ * @return int 1 if everything has been written, 0 if data remains.
+ */
+int sb_iovec_cursor_advance(SB_IovecCursor *c, size_t written);
+
+/*!
+ * @brief Returns whether the cursor reached the end of its buffers.
+ * @param c Pointer to the cursor.
+ * @return int 1 if done, 0 otherwise.
+ */
+int sb_iovec_cursor_done(const SB_IovecCursor *c);
+
+/*!
+ * @brief Issues one writev() with the remaining data and advances the cursor.
+ * @param fd Destination file descriptor.
+ * @param c Pointer to the cursor.
+ * @return ssize_t Bytes written, or -1 with errno set (EAGAIN on non-blocking fds).
+ */
+ssize_t sb_iovec_writev(int fd, SB_IovecCursor *c);
+
+/*!
+ * @brief Issues one sendmsg() with the remaining data and advances the cursor.
+ * @param fd Destination socket.
+ * @param c Pointer to the cursor.
+ * @param flags sendmsg() flags (e.g. MSG_NOSIGNAL).
+ * @return ssize_t Bytes sent, or -1 with errno set.
+ */
+ssize_t sb_iovec_sendmsg(int fd, SB_IovecCursor *c, int flags);
+
+/*!
+ * @brief Writes a list of buffers completely, retrying partial writes and EINTR.
+ * @param fd Destination file descriptor (blocking).
+ * @param bufs Array of buffer pointers.
+ * @param count Number of buffers.
+ * @return int 1 on success, 0 on error (errno is preserved).
+ */
+int sb_buffer_writev_all(int fd, SB_Buffer *const *bufs, size_t count);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_IOVEC_H */
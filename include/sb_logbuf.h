@@ -0,0 +1,130 @@
+/*!
+ * @file sb_logbuf.h
+ * @brief Multi-producer, single-consumer append buffer for loggers.
+ *
+ * Two fixed-capacity sides are built on regular buffers. Producers reserve
+ * space in the active side with a single atomic fetch-add and write their
+ * bytes in place; they never block, and an append that does not fit is
+ * dropped (and counted) instead of waiting. The consumer swaps the sides,
+ * waits for the writers still finishing on the old side and flushes it as
+ * an ordinary SB_Buffer (fwrite, sb_buffer_writev_all, ...).
+ *
+ * The producer word and each side's commit counter sit on separate cache
+ * lines. Entries of a side appear in reservation order; an entry is
+ * never split between two sides.
+ */
+#ifndef SB_LOGBUF_H
+#define SB_LOGBUF_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Value stored in SB_LogBuffer.magic once initialized. */
+#define SB_LOGBUF_MAGIC 0x106B0FF5u
+
+/*! @brief Padding that keeps the hot atomic words on separate cache lines. */
+#define SB_LOGBUF_PAD(n) char n[64]
+
+/*!
+ * @struct SB_LogBuffer
+ * @brief Double buffer shared by many producer threads and one consumer.
+ */
+typedef struct {
+    SB_LOGBUF_PAD(pad0);
+    uint64_t state;        /* Active side (top bit) | bytes reserved in it */
+    SB_LOGBUF_PAD(pad1);
+    struct {
+        size_t committed;  /* Bytes fully written by producers */
+        size_t end;        /* 1 + offset of the first rejected reservation, 0 if none */
+        SB_LOGBUF_PAD(pad);
+    } meta[2];
+    uint64_t dropped;      /* Appends rejected because the side was full */
+    SB_LOGBUF_PAD(pad2);
+    SB_BufferHeap side[2]; /* Storage of each side (cap = capacity + 1) */
+    size_t capacity;       /* Bytes per side */
+    uint32_t magic;
+} SB_LogBuffer;
+
+/*!
+ * @struct SB_LogSlot
+ * @brief Space reserved by a producer, to be filled and then committed.
+ */
+typedef struct {
+    char *ptr;     /* Where to write */
+    size_t len;    /* Bytes reserved */
+    unsigned side; /* Side the space belongs to */
+} SB_LogSlot;
+
+/*!
+ * @brief Initializes a log buffer with two sides of capacity bytes each.
+ * @param lb Pointer to the log buffer.
+ * @param capacity Bytes per side (the largest possible single entry).
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_logbuf_init(SB_LogBuffer *lb, size_t capacity);
+
+/*!
+ * @brief Reserves len bytes in the active side (any thread, never blocks).
+ *
+ * Write exactly slot->len bytes at slot->ptr, then call sb_logbuf_commit().
+ * @param lb Pointer to the log buffer.
+ * @param len Bytes to reserve.
+ * @param slot Receives the reserved space.
+ * @return int 1 on success, 0 if the side is full (the entry is dropped) or the input is invalid.
+ */
+int sb_logbuf_prepare(SB_LogBuffer *lb, size_t len, SB_LogSlot *slot);
+
+/*!
+ * @brief Publishes the bytes written in a slot (any thread, never blocks).
+ * @param lb Pointer to the log buffer.
+ * @param slot Slot filled by sb_logbuf_prepare().
+ */
+void sb_logbuf_commit(SB_LogBuffer *lb, const SB_LogSlot *slot);
+
+/*!
+ * @brief Appends len bytes as one entry (prepare, copy, commit).
+ * @param lb Pointer to the log buffer.
+ * @param s Bytes to append.
+ * @param len Number of bytes.
+ * @return int 1 on success, 0 if the entry was dropped or the input is invalid.
+ */
+int sb_logbuf_append(SB_LogBuffer *lb, const char *s, size_t len);
+
+/*!
+ * @brief Switches sides and returns the content of the side that was active (consumer only).
+ *
+ * Waits (spinning) until the producers that reserved space in that side have
+ * committed. The returned buffer must not be modified and stays valid until
+ * the next call.
+ * @param lb Pointer to the log buffer.
+ * @return SB_Buffer* The completed side (possibly empty), or NULL on invalid input.
+ */
+SB_Buffer *sb_logbuf_swap(SB_LogBuffer *lb);
+
+/*!
+ * @brief Bytes currently reserved in the active side (approximate, for flush thresholds).
+ */
+size_t sb_logbuf_pending(SB_LogBuffer *lb);
+
+/*!
+ * @brief Number of appends dropped so far because a side was full.
+ */
+uint64_t sb_logbuf_dropped(SB_LogBuffer *lb);
+
+/*!
+ * @brief Releases the storage. No producer may use the log buffer anymore.
+ * @param lb Pointer to the log buffer.
+ * @return int 1 on success, 0 on invalid input.
+ */
+int sb_logbuf_finalize(SB_LogBuffer *lb);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_LOGBUF_H */
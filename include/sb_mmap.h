@@ -0,0 +1,76 @@
+/*!
+ * @file sb_mmap.h
+ * @brief Memory-mapped files as the storage of an SB_Buffer.
+ *
+ * Two modes share one allocator:
+ *   - Output (sb_buffer_map_file): the buffer storage is a shared mapping of
+ *     the file. Growth extends the file with ftruncate and the mapping with
+ *     mremap, so multi-GB outputs are paged out by the kernel instead of
+ *     sitting in anonymous memory. sb_buffer_close_file() trims the file to
+ *     the content length.
+ *   - Load (sb_buffer_load_file): the file is mapped privately and used as
+ *     the buffer content at once, without reading or copying it. Appending
+ *     works (pages are copied on write); growing past the mapping moves the
+ *     content to the heap.
+ *
+ * In both modes str/len behave as usual and the content is null-terminated.
+ * The SB_FileMap must outlive the use of the buffer. POSIX only.
+ */
+#ifndef SB_MMAP_H
+#define SB_MMAP_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @struct SB_FileMap
+ * @brief Mapping state and allocator vtable of a file-backed buffer.
+ */
+typedef struct {
+    SB_Allocator allocator; /* Vtable handed to the buffer (ctx is the map) */
+    char *base;             /* Current mapping, NULL if none */
+    size_t map_len;         /* Bytes mapped at base */
+    int fd;                 /* Output file, -1 in load mode */
+} SB_FileMap;
+
+/*!
+ * @brief Makes a file the storage of the buffer (output mode).
+ *
+ * The file is created or truncated; the current content of the buffer
+ * becomes its beginning.
+ * @param b Pointer to the Buffer structure.
+ * @param m Mapping state (owned by the caller).
+ * @param path File to write.
+ * @return int 1 on success, 0 on failure (errno is set by the failing call).
+ */
+int sb_buffer_map_file(SB_Buffer *b, SB_FileMap *m, const char *path);
+
+/*!
+ * @brief Replaces the content of the buffer with a file, mapped without copying (load mode).
+ * @param b Pointer to the Buffer structure.
+ * @param m Mapping state (owned by the caller).
+ * @param path File to load.
+ * @return int 1 on success, 0 on failure (errno is set by the failing call).
+ */
+int sb_buffer_load_file(SB_Buffer *b, SB_FileMap *m, const char *path);
+
+/*!
+ * @brief Detaches a file-backed buffer, leaving it empty on its inline storage.
+ *
+ * In output mode the file is truncated to the content length and closed.
+ * Use this instead of sb_buffer_finalize() for file-backed buffers.
+ * @param b Pointer to the Buffer structure.
+ * @return int 1 on success, 0 on failure (invalid input, not file-backed, or ftruncate failed).
+ */
+int sb_buffer_close_file(SB_Buffer *b);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_MMAP_H */
@@ -0,0 +1,102 @@
+/*!
+ * @file sb_pool.h
+ * @brief Thread-aware pool of warmed-up heap blocks for SB_Buffer instances.
+ *
+ * sb_buffer_pool_acquire() hands a buffer a heap block taken from the pool
+ * and sb_buffer_pool_release() gives it back instead of freeing it. Blocks
+ * are grouped in power-of-two size classes (SB_POOL_MIN_SIZE to
+ * SB_POOL_MAX_SIZE). Each thread keeps its own free lists, touched without
+ * locks or atomics; a thread that goes over its high-water mark spills to a
+ * shared overflow stage, which the other threads draw from when their own
+ * lists are empty. Once the pool is warm, request handling does no malloc
+ * or free at all.
+ *
+ * Pooled blocks use sb_buffer_malloc_allocator, so a pooled buffer can also
+ * be finalized normally. Requires POSIX threads.
+ */
+#ifndef SB_POOL_H
+#define SB_POOL_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Smallest pooled block (smaller buffers stay inline or use malloc). */
+#define SB_POOL_MIN_SIZE 512
+
+/*! @brief Largest pooled block; bigger blocks are always freed on release. */
+#define SB_POOL_MAX_SIZE (1u << 20)
+
+/*! @brief Default number of blocks per size class kept by each thread. */
+#ifndef SB_POOL_LOCAL_HIGH_WATER
+#define SB_POOL_LOCAL_HIGH_WATER 16
+#endif
+
+/*! @brief Default number of blocks per size class kept in the overflow stage. */
+#ifndef SB_POOL_GLOBAL_HIGH_WATER
+#define SB_POOL_GLOBAL_HIGH_WATER 64
+#endif
+
+/*!
+ * @struct SB_PoolStats
+ * @brief Pool counters, summed over all the threads (including exited ones).
+ */
+typedef struct {
+    uint64_t hits;        /* Acquires served from the pool */
+    uint64_t global_hits; /* Part of hits served from the overflow stage */
+    uint64_t misses;      /* Acquires that had to allocate */
+    uint64_t releases;    /* Blocks kept by the pool on release */
+    uint64_t drops;       /* Blocks freed on release (pool full or size not pooled) */
+} SB_PoolStats;
+
+/*!
+ * @brief Gives the buffer a heap block able to hold min_len bytes, taken from the pool.
+ *
+ * The current content is kept. Does nothing if the buffer already has enough
+ * capacity; a heap block it was using is released to the pool.
+ * @param b Pointer to the Buffer structure.
+ * @param min_len Content length the buffer must be able to hold.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_pool_acquire(SB_Buffer *b, size_t min_len);
+
+/*!
+ * @brief Returns the heap block of the buffer to the pool and resets it to its inline state.
+ *
+ * Blocks that do not come from sb_buffer_malloc_allocator, or whose size is
+ * outside the pooled range, are freed as sb_buffer_reset() would.
+ * @param b Pointer to the Buffer structure.
+ * @return int 1 on success, 0 if the pointer is invalid.
+ */
+int sb_buffer_pool_release(SB_Buffer *b);
+
+/*!
+ * @brief Sets the high-water marks (blocks per size class).
+ *
+ * Existing cached blocks above the new marks are freed lazily, as they are released.
+ * @param local_blocks Blocks kept by each thread (0 disables the thread caches).
+ * @param global_blocks Blocks kept in the overflow stage (0 disables it).
+ */
+void sb_buffer_pool_set_limits(size_t local_blocks, size_t global_blocks);
+
+/*!
+ * @brief Frees the blocks cached by the calling thread and by the overflow stage.
+ */
+void sb_buffer_pool_trim(void);
+
+/*!
+ * @brief Reads the pool counters.
+ * @param stats Receives the counters.
+ * @return int 1 on success, 0 if the pointer is NULL.
+ */
+int sb_buffer_pool_stats(SB_PoolStats *stats);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_POOL_H */
@@ -0,0 +1,193 @@
+/*!
+ * @file sb_rope.h
+ * @brief Chunked (rope) companion of SB_Buffer for multi-MB payloads.
+ *
+ * Content is stored in a linked list of fixed-size segments. Appends only
+ * ever write into the newest segment, so growing never copies what was
+ * already written and never needs one large contiguous block. The memory
+ * overhead is bounded by one partially filled segment.
+ */
+#ifndef SB_ROPE_H
+#define SB_ROPE_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Default segment size. */
+#ifndef SB_ROPE_SEGMENT_SIZE
+#define SB_ROPE_SEGMENT_SIZE 65536
+#endif
+
+/*! @brief Unique value used to identify a valid Rope instance. */
+#define SB_ROPE_MAGIC 0xC0DECAFE
+
+/*!
+ * @struct SB_RopeSeg
+ * @brief One segment of a rope; its data follows the header.
+ */
+typedef struct SB_RopeSeg {
+    struct SB_RopeSeg *next;
+    size_t len;  /* Bytes used in this segment */
+} SB_RopeSeg;
+
+/*!
+ * @struct SB_Rope
+ * @brief Segmented string buffer.
+ */
+typedef struct {
+    uint32_t magic;            /* Signature for validity check */
+    SB_RopeSeg *head;          /* Oldest segment */
+    SB_RopeSeg *tail;          /* Newest segment: the only one written to */
+    size_t len;                /* Total content length */
+    size_t seg_size;           /* Data capacity of every segment */
+    size_t nsegs;              /* Number of segments */
+    const SB_Allocator *alloc; /* Owner of the segments */
+} SB_Rope;
+
+/*!
+ * @brief Initializes an empty rope. No memory is taken until the first append.
+ * @param r Pointer to the rope.
+ * @param seg_size Segment size, or 0 for SB_ROPE_SEGMENT_SIZE.
+ * @return int 1 on success, 0 if the pointer is NULL.
+ */
+int sb_rope_init(SB_Rope *r, size_t seg_size);
+
+/*!
+ * @brief Appends a string of known length.
+ *
+ * All or nothing: if a segment cannot be allocated midway, the part already
+ * copied is dropped and the rope is left as it was.
+ * @param r Pointer to the rope.
+ * @param s Pointer to the source data.
+ * @param len Length of the data.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_rope_add_lstring(SB_Rope *r, const char *s, size_t len);
+
+/*!
+ * @brief Appends a single character.
+ * @param r Pointer to the rope.
+ * @param c Character to append.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_rope_add_char(SB_Rope *r, char c);
+
+/*!
+ * @brief Appends formatted text (printf syntax).
+ *
+ * Formats in place when the result fits in the newest segment, otherwise
+ * once into a temporary buffer that is then split across segments.
+ * @param r Pointer to the rope.
+ * @param fmt printf format string.
+ * @return int 1 on success, 0 on failure (formatting error, memory allocation failed or invalid input).
+ */
+int sb_rope_appendf(SB_Rope *r, const char *fmt, ...) SB_BUFFER_PRINTF(2, 3);
+
+/*!
+ * @brief va_list version of sb_rope_appendf().
+ * @param r Pointer to the rope.
+ * @param fmt printf format string.
+ * @param ap Argument list.
+ * @return int 1 on success, 0 on failure (formatting error, memory allocation failed or invalid input).
+ */
+int sb_rope_vappendf(SB_Rope *r, const char *fmt, va_list ap);
+
+/*!
+ * @brief Returns the total length of the content.
+ * @param r Pointer to the rope.
+ * @return size_t The content length, or 0 if the pointer is invalid.
+ */
+size_t sb_rope_get_len(SB_Rope *r);
+
+/*!
+ * @brief Copies the whole content into dest (appended, one reserve).
+ * @param r Pointer to the rope.
+ * @param dest Pointer to an initialized SB_Buffer.
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_rope_flatten(SB_Rope *r, SB_Buffer *dest);
+
+/*!
+ * @brief Copies the whole content into a single null-terminated allocation.
+ * @param r Pointer to the rope.
+ * @param out_len Receives the content length (may be NULL).
+ * @return char* Block obtained from the rope's allocator (release with its free hook,
+ *         i.e. free() by default), or NULL on failure.
+ */
+char *sb_rope_flatten_alloc(SB_Rope *r, size_t *out_len);
+
+/*!
+ * @brief Returns the first segment, for iteration.
+ * @param r Pointer to the rope.
+ * @return const SB_RopeSeg* The first segment, or NULL when empty.
+ */
+const SB_RopeSeg *sb_rope_first(const SB_Rope *r);
+
+/*!
+ * @brief Returns the segment following seg.
+ * @param seg Current segment.
+ * @return const SB_RopeSeg* The next segment, or NULL at the end.
+ */
+const SB_RopeSeg *sb_rope_next(const SB_RopeSeg *seg);
+
+/*!
+ * @brief Returns the data of a segment (seg->len bytes, not null-terminated).
+ * @param seg A segment.
+ * @return const char* Pointer to the segment data.
+ */
+const char *sb_rope_seg_data(const SB_RopeSeg *seg);
+
+/*!
+ * @brief Fills an SB_Slice (struct iovec compatible) array with the segments, for writev().
+ * @param r Pointer to the rope.
+ * @param out Destination array.
+ * @param max Capacity of out.
+ * @return size_t Number of entries filled.
+ */
+size_t sb_rope_fill_slices(SB_Rope *r, SB_Slice *out, size_t max);
+
+/*!
+ * @brief Empties the rope, keeping the first segment for reuse.
+ * @param r Pointer to the rope.
+ * @return int 1 on success, 0 if the pointer is invalid.
+ */
+int sb_rope_clear(SB_Rope *r);
+
+/*!
+ * @brief Releases every segment.
+ * @param r Pointer to the rope.
+ * @return int 1 on success, 0 if the pointer is invalid.
+ */
+int sb_rope_finalize(SB_Rope *r);
+
+/* --- Convenience Macros --- */
+
+/*! @brief Validity check for ropes (see CHECK_SB_BUFFER_POINTER_RET). */
+#ifndef SB_BUFFER_UNCHECKED
+#define CHECK_SB_ROPE_POINTER_RET(r, ret) \
+    do { \
+        if ( (r) == NULL || (r)->magic != SB_ROPE_MAGIC) { \
+            sb_buffer_report_invalid(__FILE__, __LINE__); \
+            return ret; \
+        } \
+    } while(0)
+#else
+#define CHECK_SB_ROPE_POINTER_RET(r, ret) do { } while(0)
+#endif
+
+/*! @brief Appends a null-terminated string. */
+#define sb_rope_add_string(r, s) sb_rope_add_lstring(r, s, strlen(s))
+
+/*! @brief Appends a string literal (length computed at compile time). */
+#define sb_rope_add_literal(r, literal) sb_rope_add_lstring(r, literal, (sizeof(literal)-1))
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_ROPE_H */
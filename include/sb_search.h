@@ -0,0 +1,160 @@
+/*!
+ * @file sb_search.h
+ * @brief Vectorized search and scan primitives over SB_Buffer contents.
+ *
+ * Every primitive has SSE2/AVX2 (x86) and NEON (ARM) kernels selected at run
+ * time, plus a portable scalar fallback (also used with -DSB_BUFFER_NO_SIMD).
+ * Offsets are byte positions in the content; SB_BUFFER_NPOS means "not found".
+ */
+#ifndef SB_SEARCH_H
+#define SB_SEARCH_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @struct SB_Tokenizer
+ * @brief Iterator over the fields (or lines) of a buffer.
+ */
+typedef struct {
+    const char *str;   /* Content being split */
+    size_t len;        /* Content length */
+    size_t pos;        /* Start of the next field */
+    const char *delims;/* Null-terminated delimiter set */
+    int done;          /* Set once the last field was returned */
+} SB_Tokenizer;
+
+/* --- Raw memory kernels --- */
+
+/*!
+ * @brief Finds the first occurrence of byte c in p[0..n).
+ * @return size_t Offset of the match, or SB_BUFFER_NPOS.
+ */
+size_t sb_search_byte(const char *p, size_t n, char c);
+
+/*!
+ * @brief Finds the first byte of p[0..n) that belongs to the null-terminated set.
+ * @return size_t Offset of the match, or SB_BUFFER_NPOS.
+ */
+size_t sb_search_any(const char *p, size_t n, const char *set);
+
+/*!
+ * @brief Counts the occurrences of byte c in p[0..n).
+ * @return size_t Number of occurrences.
+ */
+size_t sb_search_count(const char *p, size_t n, char c);
+
+/*!
+ * @brief Finds the first occurrence of needle[0..m) in p[0..n) (memmem).
+ * @return size_t Offset of the match (0 for an empty needle), or SB_BUFFER_NPOS.
+ */
+size_t sb_search_mem(const char *p, size_t n, const char *needle, size_t m);
+
+/*!
+ * @brief Name of the kernel family selected for this CPU ("avx2", "sse2", "neon" or "scalar").
+ */
+const char *sb_search_kernel_name(void);
+
+/*!
+ * @brief Forces a kernel family (for benchmarks and tests). Not thread-safe.
+ * @param name "avx2", "sse2", "neon", "scalar", or NULL to restore the automatic choice.
+ * @return int 1 on success, 0 if that family is not available on this build/CPU.
+ */
+int sb_search_set_kernel(const char *name);
+
+/* --- Buffer API --- */
+
+/*!
+ * @brief Finds needle[0..nlen) in the buffer content, starting at offset start.
+ * @param b Pointer to the Buffer structure.
+ * @param start First offset to examine.
+ * @param needle Bytes to look for.
+ * @param nlen Length of needle.
+ * @return size_t Offset of the match, or SB_BUFFER_NPOS (also on invalid input).
+ */
+size_t sb_buffer_find(SB_Buffer *b, size_t start, const char *needle, size_t nlen);
+
+/*!
+ * @brief Finds byte c in the buffer content, starting at offset start.
+ * @param b Pointer to the Buffer structure.
+ * @param start First offset to examine.
+ * @param c Byte to look for.
+ * @return size_t Offset of the match, or SB_BUFFER_NPOS (also on invalid input).
+ */
+size_t sb_buffer_find_char(SB_Buffer *b, size_t start, char c);
+
+/*!
+ * @brief Finds the first byte that belongs to charset, starting at offset start.
+ *
+ * Typical uses: "\r\n" to find line ends, "\"\\<>&" to check whether escaping is needed.
+ * @param b Pointer to the Buffer structure.
+ * @param start First offset to examine.
+ * @param charset Null-terminated set of bytes.
+ * @return size_t Offset of the match, or SB_BUFFER_NPOS (also on invalid input).
+ */
+size_t sb_buffer_find_any(SB_Buffer *b, size_t start, const char *charset);
+
+/*!
+ * @brief Counts the occurrences of byte c in the buffer content.
+ * @param b Pointer to the Buffer structure.
+ * @param c Byte to count.
+ * @return size_t Number of occurrences (0 on invalid input).
+ */
+size_t sb_buffer_count_char(SB_Buffer *b, char c);
+
+/*!
+ * @brief Replaces every occurrence of from[0..flen) with to[0..tlen).
+ *
+ * Non-overlapping matches, left to right. The content is rebuilt in one
+ * forward pass: in place when the replacement is not longer, otherwise after
+ * growing once to the exact final size and moving the content to the end of
+ * the block.
+ * @param b Pointer to the Buffer structure.
+ * @param from Bytes to look for (must not point into the buffer).
+ * @param flen Length of from (at least 1).
+ * @param to Replacement bytes (must not point into the buffer).
+ * @param tlen Length of to (may be 0 to delete the matches).
+ * @return int 1 on success (with or without matches), 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_buffer_replace_all(SB_Buffer *b, const char *from, size_t flen, const char *to, size_t tlen);
+
+/*!
+ * @brief Starts iterating over the fields of a buffer separated by any byte of delims.
+ *
+ * The buffer must not be modified while the tokenizer is in use.
+ * @param t Pointer to the tokenizer.
+ * @param b Pointer to the Buffer structure.
+ * @param delims Null-terminated delimiter set (must outlive the tokenizer).
+ * @return int 1 on success, 0 on invalid input.
+ */
+int sb_tokenizer_init(SB_Tokenizer *t, SB_Buffer *b, const char *delims);
+
+/*!
+ * @brief Returns the next field (empty fields between adjacent delimiters included).
+ * @param t Pointer to the tokenizer.
+ * @param field Receives the field, pointing into the buffer content.
+ * @return int 1 if a field was returned, 0 at the end.
+ */
+int sb_tokenizer_next(SB_Tokenizer *t, SB_Slice *field);
+
+/*!
+ * @brief Returns the next line, without its "\n" or "\r\n" terminator.
+ *
+ * Ignores the tokenizer delimiters. A final line without terminator is
+ * returned; an empty remainder after the last "\n" is not.
+ * @param t Pointer to the tokenizer.
+ * @param line Receives the line, pointing into the buffer content.
+ * @return int 1 if a line was returned, 0 at the end.
+ */
+int sb_tokenizer_next_line(SB_Tokenizer *t, SB_Slice *line);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_SEARCH_H */
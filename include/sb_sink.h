@@ -0,0 +1,52 @@
+/*!
+ * @file sb_sink.h
+ * @brief Ready-made sinks for sb_buffer_set_sink(): file descriptors and stdio streams.
+ *
+ *     SB_FdSink out;
+ *     SB_Buffer SB_INIT(b);
+ *     sb_buffer_set_sink(&b, sb_fd_sink_init(&out, fd), 0);
+ *     ... appends of any total size, memory stays at one 64 KiB block ...
+ *     sb_buffer_flush(&b);
+ */
+#ifndef SB_SINK_H
+#define SB_SINK_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @struct SB_FdSink
+ * @brief Sink writing to a file descriptor (partial writes and EINTR are retried).
+ */
+typedef struct {
+    SB_Sink sink;     /* Vtable handed to the buffer (ctx is this struct) */
+    int fd;
+    uint64_t written; /* Total bytes written so far */
+} SB_FdSink;
+
+/*!
+ * @brief Initializes a file descriptor sink.
+ * @param s Pointer to the sink (must outlive the buffer using it).
+ * @param fd Destination file descriptor (blocking).
+ * @return SB_Sink* The sink to pass to sb_buffer_set_sink(), or NULL if s is NULL.
+ */
+SB_Sink *sb_fd_sink_init(SB_FdSink *s, int fd);
+
+/*!
+ * @brief Initializes a sink writing to a stdio stream with fwrite.
+ * @param s Pointer to the sink (must outlive the buffer using it).
+ * @param f Destination stream.
+ * @return SB_Sink* s, or NULL if an argument is NULL.
+ */
+SB_Sink *sb_stdio_sink_init(SB_Sink *s, FILE *f);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_SINK_H */
@@ -0,0 +1,65 @@
+/*!
+ * @file sb_stats.h
+ * @brief Opt-in allocation and growth counters for SB_Buffer.
+ *
+ * Build the library with -DSB_BUFFER_STATS (CMake option SB_BUFFER_STATS)
+ * to record, per thread and without locks, how often buffers leave their
+ * inline storage, how many reallocations and copied bytes growth costs,
+ * the peak capacity, and a histogram of content sizes at finalize. The
+ * counters are summed over all threads when read. Without the option the
+ * recording is compiled out and the functions below report nothing.
+ */
+#ifndef SB_STATS_H
+#define SB_STATS_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Number of histogram buckets: 16 B, 32 B, ... 16 MiB, then +Inf. */
+#define SB_STATS_BUCKETS 22
+
+/*!
+ * @struct SB_BufferStats
+ * @brief Counters summed over all the threads (including exited ones).
+ */
+typedef struct {
+    uint64_t sso_exits;      /* Inline storage -> first heap block */
+    uint64_t reallocs;       /* Capacity changes of a heap block (growth, reserve, shrink) */
+    uint64_t bytes_copied;   /* Bytes moved by growth (migration or a realloc that moved) */
+    uint64_t peak_capacity;  /* Largest capacity set on any buffer */
+    uint64_t frees;          /* Heap blocks released by reset/finalize */
+    uint64_t resets;         /* sb_buffer_reset calls */
+    uint64_t finalizes;      /* sb_buffer_finalize calls */
+    uint64_t copies;         /* sb_buffer_copy calls */
+    uint64_t copy_bytes;     /* Bytes copied by sb_buffer_copy */
+    uint64_t final_size[SB_STATS_BUCKETS]; /* Content sizes at finalize (bucket k: <= 16 << k) */
+    uint64_t final_size_sum; /* Sum of the content sizes at finalize */
+} SB_BufferStats;
+
+/*!
+ * @brief Reads the counters.
+ * @param stats Receives the counters (all zero when stats are compiled out).
+ * @return int 1 on success, 0 if the pointer is NULL or stats are compiled out.
+ */
+int sb_buffer_stats_get(SB_BufferStats *stats);
+
+/*!
+ * @brief Appends the counters in Prometheus text exposition format.
+ *
+ * Metric names start with "sb_buffer_"; the size histogram is
+ * sb_buffer_final_size_bytes.
+ * @param out Buffer receiving the text.
+ * @return int 1 on success, 0 on failure (invalid input, memory allocation failed, or stats compiled out).
+ */
+int sb_buffer_stats_prometheus(SB_Buffer *out);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_STATS_H */
@@ -0,0 +1,112 @@
+/*!
+ * @file sb_uring.h
+ * @brief Asynchronous write-out of SB_Buffer batches with io_uring (Linux).
+ *
+ * The writer takes ownership of completed buffers (their storage is moved,
+ * not copied), turns each batch into one IORING_OP_WRITEV or
+ * IORING_OP_SENDMSG and submits everything queued with a single
+ * io_uring_enter(). The batches of one fd are linked so that they reach
+ * it in queue order; short writes are resumed. When a write completes,
+ * the storage goes back to the buffer pool (sb_pool.h) for the next
+ * response.
+ *
+ * Where io_uring is not available (other systems, old kernels, seccomp
+ * filters) the same API falls back to synchronous writev/sendmsg, so
+ * callers do not need a second code path (setting SB_URING_DISABLE in
+ * the environment forces it). Not thread-safe: use one writer per thread.
+ */
+#ifndef SB_URING_H
+#define SB_URING_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Largest number of buffers in one batch (one iovec array). */
+#define SB_URING_MAX_BATCH 16
+
+/*! @brief Flag for sb_uring_queue(): fd is a socket, use sendmsg (MSG_NOSIGNAL). */
+#define SB_URING_SEND 0x1u
+
+/*!
+ * @struct SB_Uring
+ * @brief io_uring instance plus the batches it owns until completion.
+ */
+typedef struct {
+    int ring_fd;           /* -1 in synchronous fallback mode */
+    unsigned entries;      /* Ring size = number of batch slots */
+    void *sq_ring, *cq_ring, *sqes; /* Shared ring mappings */
+    size_t sq_ring_size, cq_ring_size, sqes_size;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    void *cqes;
+    void *slots;           /* Batch slots (internal) */
+    unsigned free_slot;    /* Head of the free slot list */
+    unsigned to_submit;    /* Entries queued but not yet submitted */
+    unsigned in_flight;    /* Batches submitted and not completed */
+    unsigned seq;          /* Queue order of the next batch */
+    uint64_t bytes_written;
+    uint64_t errors;       /* Batches that failed (their buffers are dropped) */
+    uint64_t errors_reported; /* Value of errors at the last flush */
+    int last_error;        /* errno of the last failure */
+} SB_Uring;
+
+/*!
+ * @brief Creates the ring (or selects the synchronous fallback).
+ * @param u Pointer to the writer.
+ * @param entries Batches that can be in flight at once (e.g. 64).
+ * @return int 1 on success, 0 on failure (memory allocation failed or invalid input).
+ */
+int sb_uring_init(SB_Uring *u, unsigned entries);
+
+/*!
+ * @brief Returns 1 if the writer uses io_uring, 0 if it fell back to synchronous writes.
+ */
+int sb_uring_is_async(const SB_Uring *u);
+
+/*!
+ * @brief Takes ownership of count buffers and queues them as one write to fd.
+ *
+ * The content of every buffer is moved into the writer and the buffers are
+ * left empty, ready for the next use. A slot is recycled first (waiting for
+ * a completion if needed) when all of them are busy. Nothing reaches the
+ * kernel until sb_uring_submit() (fallback mode writes immediately).
+ * @param u Pointer to the writer.
+ * @param fd Destination file descriptor or socket.
+ * @param bufs Buffers to write, in order.
+ * @param count Number of buffers (1 to SB_URING_MAX_BATCH).
+ * @param flags 0 or SB_URING_SEND.
+ * @return int 1 on success, 0 on failure (invalid input, or the write failed in fallback mode).
+ */
+int sb_uring_queue(SB_Uring *u, int fd, SB_Buffer *const *bufs, size_t count, unsigned flags);
+
+/*!
+ * @brief Submits every queued batch with one system call and reaps available completions.
+ * @param u Pointer to the writer.
+ * @return int 1 on success, 0 if io_uring_enter failed (errno is set).
+ */
+int sb_uring_submit(SB_Uring *u);
+
+/*!
+ * @brief Submits and waits until every batch has completed.
+ * @param u Pointer to the writer.
+ * @return int 1 if all the writes succeeded, 0 if some failed since the last call (see last_error).
+ */
+int sb_uring_flush(SB_Uring *u);
+
+/*!
+ * @brief Flushes, then releases the ring and the slots.
+ * @param u Pointer to the writer.
+ * @return int Result of the final flush.
+ */
+int sb_uring_finalize(SB_Uring *u);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_URING_H */
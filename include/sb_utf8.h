@@ -0,0 +1,63 @@
+/*!
+ * @file sb_utf8.h
+ * @brief UTF-8 validation and UTF-16 to UTF-8 transcoding into an SB_Buffer.
+ *
+ * Both appends size the output once for the worst case with
+ * sb_buffer_prepare() and write it straight into the spare capacity, so the
+ * input is read a single time. Validation follows RFC 3629: overlong forms,
+ * surrogates (U+D800..U+DFFF) and code points above U+10FFFF are rejected.
+ * The kernels check 16 bytes per step with table lookups (SSSE3, chosen at
+ * run time on x86, or NEON) and skip pure ASCII blocks; the transcoder
+ * converts blocks of 8 ASCII or 2-byte code units with SSE2.
+ */
+#ifndef SB_UTF8_H
+#define SB_UTF8_H
+
+#include "sb_buffer.h"
+
+/* C++ compatibility wrapper */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Checks that s[0, len) is well-formed UTF-8.
+ * @param s The bytes to check (need not be NUL-terminated).
+ * @param len Length of s in bytes.
+ * @return int 1 if valid (an empty input is), 0 otherwise.
+ */
+int sb_utf8_valid(const char *s, size_t len);
+
+/*!
+ * @brief Appends s[0, len) to the buffer if it is well-formed UTF-8.
+ *
+ * The bytes are validated while they are copied into the buffer; on invalid
+ * input the content is left unchanged.
+ * @param b Pointer to the Buffer structure.
+ * @param s The bytes to append.
+ * @param len Length of s in bytes.
+ * @return int 1 on success, 0 if s is not valid UTF-8 or on allocation failure.
+ */
+int sb_buffer_add_utf8_validated(SB_Buffer *b, const char *s, size_t len);
+
+#define sb_buffer_add_utf8_validated_literal(b, literal) sb_buffer_add_utf8_validated(b, literal, (sizeof(literal)-1))
+
+/*!
+ * @brief Appends UTF-16 code units transcoded to UTF-8.
+ *
+ * The units are in host byte order (UTF-16LE on little-endian machines).
+ * At most 3 bytes are written per unit. An unpaired surrogate rejects the
+ * whole input and leaves the content unchanged.
+ * @param b Pointer to the Buffer structure.
+ * @param units The UTF-16 code units.
+ * @param count Number of code units (not bytes).
+ * @return int 1 on success, 0 on invalid UTF-16 or allocation failure.
+ */
+int sb_buffer_add_utf16_as_utf8(SB_Buffer *b, const uint16_t *units, size_t count);
+
+/* Close C++ compatibility wrapper */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SB_UTF8_H */
@@ -0,0 +1,71 @@
+
+/*
+     Checks sb_buffer_add_double() against snprintf("%.*f") on near-tie and
+     random values, for every number of decimals.
+
+     gcc -o add_double_check add_double_check.c -I../include -L../build -lsb_buffer -lpthread
+
+*/
+
+#include "sb_buffer.h"
+#include <stdio.h>
+#include <string.h>
+
+/* xorshift64: deterministic inputs */
+static uint64_t rng = 88172645463325252ull;
+
+static uint64_t next(void){
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+static int mismatches;
+
+static void check(double v, int decimals){
+    SB_Buffer SB_INIT(b);
+    char ref[64];
+
+    sb_buffer_add_double(&b, v, decimals);
+    snprintf(ref, sizeof(ref), "%.*f", decimals, v);
+    if (strcmp(ref, b.str) != 0) {
+        if (mismatches < 10) printf("FAIL %.17g %d decimals: \"%s\", printf \"%s\"\n", v, decimals, b.str, ref);
+        mismatches++;
+    }
+    sb_buffer_finalize(&b);
+}
+
+int main(void){
+    /* Exact ties (half to even) and values just off a tie */
+    static const double fixed[] = {
+        0.5, 1.5, 2.5, 0.125, 0.375, 0.0, -0.0, 0.05, 0.25, 2.675, 1.005,
+        -36.6265, -45.8765, 37.693714645, 999999.9999995, 1e17 + 0.5
+    };
+    size_t i;
+    int d;
+
+    for (i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        for (d = 0; d <= SB_BUFFER_DOUBLE_MAX_DECIMALS; d++) check(fixed[i], d);
+    }
+
+    for (i = 0; i < 1000000; i++) {
+        double v;
+        uint64_t u = next();
+        d = (int)(next() % (SB_BUFFER_DOUBLE_MAX_DECIMALS + 1));
+        switch (i % 4) {
+        case 0: v = (double)((int64_t)(u % 2000000) - 1000000) / 10000.0; break; /* Ties at 3 decimals */
+        case 1: v = (double)(u % 100000000000ull) / 1e9; break;
+        case 2: memcpy(&v, &u, sizeof(v)); if (v != v || v >= 1e18 || v <= -1e18) continue; break;
+        default: v = (double)(u % ((uint64_t)1 << 52)) / (double)((uint64_t)1 << (next() % 52)); break;
+        }
+        check((next() & 1) ? v : -v, d);
+    }
+
+    if (mismatches) {
+        printf("%d mismatches against printf\n", mismatches);
+        return 1;
+    }
+    printf("sb_buffer_add_double matches printf\n");
+    return 0;
+}
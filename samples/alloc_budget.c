@@ -0,0 +1,242 @@
+
+/*
+     Allocation budgets: counts every call that reaches the allocator hooks
+     and fails when an API makes more calls than it is allowed to.
+
+     gcc -o alloc_budget alloc_budget.c -I../include -L../build -lsb_buffer -lpthread
+
+*/
+
+#include "sb_buffer.h"
+#include "sb_codec.h"
+#include "sb_escape.h"
+#include "sb_pool.h"
+#include "sb_utf8.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* --- Counting allocator --- */
+
+static size_t allocs, reallocs, frees;
+
+static void *count_alloc(void *ctx, size_t size){
+    (void)ctx;
+    allocs++;
+    return malloc(size);
+}
+
+static void *count_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size){
+    (void)ctx; (void)old_size;
+    reallocs++;
+    return realloc(ptr, new_size);
+}
+
+static void count_free(void *ctx, void *ptr, size_t size){
+    (void)ctx; (void)size;
+    frees++;
+    free(ptr);
+}
+
+static const SB_Allocator counting = { count_alloc, count_realloc, count_free, NULL };
+
+static int failures;
+
+#define CALLS() (allocs + reallocs + frees)
+
+/* Runs stmt and checks that it made at most max allocator calls */
+#define BUDGET(name, max, stmt) do { \
+        size_t before_ = CALLS(); \
+        stmt; \
+        report(name, CALLS() - before_, (max)); \
+    } while (0)
+
+/* Checks a condition that is not a call count (content, pool counters) */
+#define EXPECT(name, cond) do { \
+        if (!(cond)) { printf("FAIL %s\n", name); failures++; } \
+    } while (0)
+
+static void report(const char *name, size_t calls, size_t max){
+    if (calls > max) {
+        printf("FAIL %-36s %zu calls (budget %zu)\n", name, calls, max);
+        failures++;
+    } else {
+        printf("ok   %-36s %zu calls (budget %zu)\n", name, calls, max);
+    }
+}
+
+static char data[1 << 16];
+
+/* --- Budgets --- */
+
+static void budget_appends(void){
+    SB_Buffer SB_INIT(b);
+    size_t i;
+
+    /* Under the inline capacity nothing reaches the allocator */
+    BUDGET("add_lstring under inline cap", 0,
+           for (i = 0; i < 25; i++) sb_buffer_add_lstring(&b, data, 10));
+    BUDGET("add_u64/appendf under inline cap", 0,
+           (sb_buffer_clear(&b), sb_buffer_add_u64(&b, 18446744073709551615ull), sb_buffer_appendf(&b, "%d:%s", 42, "x")));
+
+    /* One block for the reserve, none for the appends that fill it */
+    sb_buffer_reset(&b);
+    BUDGET("reserve", 1, sb_buffer_reserve(&b, 60000));
+    BUDGET("add_lstring within reserve", 0,
+           for (i = 0; i < 6000; i++) sb_buffer_add_lstring(&b, data, 10));
+    BUDGET("prepare/commit within reserve", 0,
+           (sb_buffer_clear(&b), sb_buffer_prepare(&b, 50000), sb_buffer_commit(&b, 50000)));
+    sb_buffer_reset(&b);
+
+    /* Geometric growth: 1 MiB in 16-byte pieces */
+    BUDGET("add_lstring 1 MiB by 16 bytes", 16,
+           for (i = 0; i < 65536; i++) sb_buffer_add_lstring(&b, data, 16));
+    EXPECT("add_lstring 1 MiB content", b.len == (size_t)1 << 20);
+    BUDGET("shrink_to_fit", 1, sb_buffer_shrink_to_fit(&b));
+
+    /* add_many sizes the destination once */
+    {
+        SB_Slice parts[32];
+        for (i = 0; i < 32; i++) { parts[i].base = data; parts[i].len = 1000; }
+        sb_buffer_reset(&b);
+        BUDGET("add_many 32 KB", 1, sb_buffer_add_many(&b, parts, 32));
+    }
+
+    BUDGET("finalize", 1, sb_buffer_finalize(&b));
+}
+
+static void budget_clear_reset(void){
+    SB_Buffer SB_INIT(b);
+    size_t i, calls;
+
+    sb_buffer_add_lstring(&b, data, 4000);
+    BUDGET("clear + refill x1000", 0,
+           for (i = 0; i < 1000; i++) { sb_buffer_clear(&b); sb_buffer_add_lstring(&b, data, 4000); });
+
+    /* reset gives the block back: every refill allocates again */
+    calls = CALLS();
+    for (i = 0; i < 1000; i++) { sb_buffer_reset(&b); sb_buffer_add_lstring(&b, data, 4000); }
+    EXPECT("reset + refill frees every cycle", frees >= 1000 && CALLS() - calls >= 2000);
+    BUDGET("reset + refill x1000", 2000,
+           for (i = 0; i < 1000; i++) { sb_buffer_reset(&b); sb_buffer_add_lstring(&b, data, 4000); });
+
+    sb_buffer_finalize(&b);
+}
+
+static void budget_copy_move(void){
+    SB_Buffer SB_INIT(src);
+    SB_Buffer SB_INIT(dest);
+    SB_Buffer SB_INIT(other);
+    size_t i;
+
+    sb_buffer_add_lstring(&src, data, 8000);
+    BUDGET("copy into empty dest", 1, sb_buffer_copy(&src, &dest));
+    BUDGET("copy into sized dest x1000", 0,
+           for (i = 0; i < 1000; i++) sb_buffer_copy(&src, &dest));
+    EXPECT("copy content", dest.len == 8000 && memcmp(dest.str, data, 8000) == 0);
+
+    /* Heap to empty: the block changes hands */
+    BUDGET("move heap block", 0, sb_buffer_move(&src, &other));
+    EXPECT("move content", other.len == 8000 && src.len == 0 && src.str[0] == '\0');
+    BUDGET("move back and forth x1000", 0,
+           for (i = 0; i < 1000; i++) { sb_buffer_move(&other, &src); sb_buffer_move(&src, &other); });
+
+    /* Inline source: copied, nothing allocated */
+    sb_buffer_reset(&src);
+    sb_buffer_add_lstring(&src, data, 100);
+    sb_buffer_reset(&dest);
+    BUDGET("move inline content", 0, sb_buffer_move(&src, &dest));
+
+    sb_buffer_finalize(&src);
+    sb_buffer_finalize(&dest);
+    sb_buffer_finalize(&other);
+}
+
+static void budget_binary_codecs(void){
+    SB_Buffer SB_INIT(b);
+    uint16_t units[1000];
+    size_t i;
+
+    for (i = 0; i < 1000; i++) units[i] = (uint16_t)(0x400 + i % 64);
+
+    sb_buffer_set_binary(&b, 1);
+    sb_buffer_reserve(&b, 4096);
+    BUDGET("binary add_data_fast to exact cap", 0,
+           for (i = 0; i < 256; i++) sb_buffer_add_data_fast(&b, data, 16));
+    EXPECT("binary fills the whole cap", b.len == 4096 && b.cap == 4096);
+    sb_buffer_reset(&b);
+    sb_buffer_set_binary(&b, 0);
+
+    /* The worst case is reserved once, whatever is written */
+    BUDGET("add_base64 48 KB", 1, sb_buffer_add_base64(&b, data, 48000));
+    sb_buffer_reset(&b);
+    BUDGET("add_utf8_validated 60 KB", 1, sb_buffer_add_utf8_validated(&b, data, 60000));
+    sb_buffer_reset(&b);
+    BUDGET("add_utf16_as_utf8 1000 units", 1, sb_buffer_add_utf16_as_utf8(&b, units, 1000));
+    EXPECT("add_utf16_as_utf8 length", b.len == 2000);
+
+    sb_buffer_finalize(&b);
+}
+
+static void budget_escape(void){
+    SB_Buffer SB_INIT(b);
+
+    /* Clean text that does not fit is measured: one block of about len bytes, not 6 * len */
+    BUDGET("add_json_escaped 4000 clean bytes", 1, sb_buffer_add_json_escaped(&b, data, 4000));
+    EXPECT("add_json_escaped sized to content", b.len == 4000 && b.cap < 2 * 4000);
+    sb_buffer_reset(&b);
+    BUDGET("add_html_escaped 4000 clean bytes", 1, sb_buffer_add_html_escaped(&b, data, 4000));
+    EXPECT("add_html_escaped sized to content", b.len == 4000 && b.cap < 2 * 4000);
+    sb_buffer_reset(&b);
+
+    /* The worst case fits the spare capacity: no growth */
+    sb_buffer_reserve(&b, 6 * 100);
+    BUDGET("add_json_escaped within reserve", 0, sb_buffer_add_json_escaped(&b, "\n\"\\", 3));
+    EXPECT("add_json_escaped content", b.len == 6 && memcmp(b.str, "\\n\\\"\\\\", 6) == 0);
+
+    sb_buffer_finalize(&b);
+}
+
+static void budget_pool(void){
+    SB_Buffer SB_INIT(b);
+    SB_PoolStats before, after;
+    size_t i;
+
+    /* Warm up one block of the class, then cycle: no allocator call and no pool miss */
+    sb_buffer_pool_acquire(&b, 3000);
+    sb_buffer_pool_release(&b);
+    sb_buffer_pool_stats(&before);
+    BUDGET("pool acquire/release x1000", 0,
+           for (i = 0; i < 1000; i++) {
+               sb_buffer_pool_acquire(&b, 3000);
+               sb_buffer_add_lstring(&b, data, 3000);
+               sb_buffer_pool_release(&b);
+           });
+    sb_buffer_pool_stats(&after);
+    EXPECT("pool served every acquire", after.misses == before.misses && after.hits - before.hits == 1000);
+
+    sb_buffer_finalize(&b);
+    sb_buffer_pool_trim();
+}
+
+int main(void){
+    size_t i;
+
+    for (i = 0; i < sizeof(data); i++) data[i] = (char)('a' + i % 26);
+    sb_buffer_set_default_allocator(&counting);
+
+    budget_appends();
+    budget_clear_reset();
+    budget_copy_move();
+    budget_binary_codecs();
+    budget_escape();
+    budget_pool();
+
+    sb_buffer_set_default_allocator(NULL);
+    if (failures) {
+        printf("%d budget(s) exceeded\n", failures);
+        return 1;
+    }
+    printf("All allocation budgets met\n");
+    return 0;
+}
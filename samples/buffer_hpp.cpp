@@ -0,0 +1,245 @@
+/*
+     Checks the C++ wrapper (sb_buffer.hpp): relocation in std::vector, the
+     moved-from state, std::allocator<char>, copy assignment, operator+=,
+     the variadic append() and sb::concat().
+
+     g++ -std=c++17 -o buffer_hpp buffer_hpp.cpp -I../include -L../build -lsb_buffer -lpthread
+
+*/
+
+#include "sb_buffer.hpp"
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static int failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+    } while (0)
+
+using small = sb::buffer<16>;
+using std_small = sb::buffer<16, std::allocator<char>>;
+
+/* std::vector relocates with the noexcept move: heap blocks change hands, nothing is copied */
+static_assert(std::is_nothrow_move_constructible_v<small>);
+static_assert(std::is_nothrow_move_assignable_v<small>);
+static_assert(std::is_nothrow_move_constructible_v<std_small>);
+
+static std::string expected(std::size_t i){
+    return "entry-" + std::to_string(i) + std::string(i % 3 == 0 ? 40 : 0, '.');
+}
+
+static void test_vector_relocation(){
+    std::vector<small> v;
+
+    for (std::size_t i = 0; i < 200; i++) {
+        small b;
+        b += expected(i);
+        v.push_back(std::move(b));
+        CHECK(b.empty() && b.c_str()[0] == '\0');
+    }
+
+    /* One heap block followed through reallocations of the vector */
+    const char *heap = v[3].data();
+    std::size_t cap = v.capacity();
+    while (v.capacity() == cap) v.emplace_back("filler");
+    CHECK(v[3].data() == heap);
+
+    for (std::size_t i = 0; i < 200; i++) CHECK(v[i] == expected(i));
+    CHECK(v.back() == "filler");
+}
+
+static void test_moved_from(){
+    small a("a string longer than sixteen bytes");
+    const char *block = a.data();
+    small b(std::move(a));
+
+    CHECK(b.data() == block && b == "a string longer than sixteen bytes");
+    CHECK(a.empty() && a.size() == 0 && a.c_str()[0] == '\0');
+    CHECK(a.data() != block);
+
+    /* Still a working buffer */
+    a += "again";
+    CHECK(a == "again");
+
+    /* Move assignment of inline content, and back over a heap block */
+    small c("short");
+    b = std::move(c);
+    CHECK(b == "short" && c.empty());
+    c = std::move(a);
+    CHECK(c == "again" && a.empty());
+}
+
+static void test_std_allocator(){
+    std_small a;
+
+    for (int i = 0; i < 100; i++) a += "0123456789";
+    CHECK(a.size() == 1000 && a.capacity() >= 1000);
+    CHECK(a.raw()->alloc != &sb_buffer_malloc_allocator);
+
+    std_small b(a);
+    CHECK(b == a.view() && b.data() != a.data());
+
+    std_small c(std::move(a));
+    CHECK(c.size() == 1000 && a.empty());
+
+    c.shrink_to_fit();
+    c.reset();
+    CHECK(c.empty());
+}
+
+static void test_copy_assignment(){
+    small a("a heap-sized source string, well past the inline part");
+    small b("tiny");
+    small c;
+
+    b = a;
+    CHECK(b == a.view() && b.data() != a.data());
+
+    c = small("x");
+    a = c;
+    CHECK(a == "x");
+
+    /* Self-assignment keeps the content */
+    const small &self = b;
+    b = self;
+    CHECK(b == "a heap-sized source string, well past the inline part");
+
+    b = std::string_view("from a view");
+    CHECK(b == "from a view");
+}
+
+static void test_plus_equal(){
+    small b;
+    char writable[32] = "ab";
+    const char with_nul[] = "x\0y";
+
+    b += "GET ";
+    b += writable;          /* strlen: 2, not sizeof - 1 */
+    b += ' ';
+    b += std::string("/path");
+    CHECK(b == "GET ab /path");
+
+    b.clear();
+    b += with_nul;          /* literal rule: sizeof - 1 bytes, the NUL included */
+    CHECK(b.size() == 3 && std::memcmp(b.data(), "x\0y", 3) == 0);
+}
+
+/* concat() is evaluated at compile time */
+static constexpr auto status_line = sb::concat("HTTP/1.1 ", "200 OK", "\r\n");
+static_assert(sb::concat("ab", "", "cd").size() == 4);
+static_assert(status_line.size() == 17);
+static_assert(std::string_view(status_line) == "HTTP/1.1 200 OK\r\n");
+static_assert(status_line.c_str()[17] == '\0');
+
+/* Integer bounds: digits10 + 1 digits plus a sign covers every value */
+template <class T>
+constexpr bool bound_fits(std::size_t longest){
+    return sb::detail::piece_size(T{}) >= longest;
+}
+static_assert(bound_fits<signed char>(4));      /* -128 */
+static_assert(bound_fits<unsigned char>(3));    /* 255 */
+static_assert(bound_fits<short>(6));            /* -32768 */
+static_assert(bound_fits<int>(11));             /* -2147483648 */
+static_assert(bound_fits<long long>(20));       /* -9223372036854775808 */
+static_assert(bound_fits<unsigned long long>(20));
+static_assert(sb::detail::piece_size("abc") == 3);
+
+/* (pointer, length) stays the two-argument append; anything else is variadic */
+static_assert(sb::detail::is_pointer_length<const char *, std::size_t>::value);
+static_assert(sb::detail::is_pointer_length<const char *&, int>::value);
+static_assert(!sb::detail::is_pointer_length<const char *, char>::value);
+static_assert(!sb::detail::is_pointer_length<const char *, bool>::value);
+static_assert(sb::detail::is_pointer_length<const char (&)[4], int>::value);    /* arrays decay */
+static_assert(!sb::detail::is_pointer_length<const char *, int, int>::value);
+
+template <class T>
+static std::string printed(T v){
+    char tmp[32];
+    if constexpr (std::is_signed_v<T>) std::snprintf(tmp, sizeof(tmp), "%lld", (long long)v);
+    else std::snprintf(tmp, sizeof(tmp), "%llu", (unsigned long long)v);
+    return tmp;
+}
+
+template <class T>
+static void check_extremes(){
+    small b;
+    b.append(std::numeric_limits<T>::min());
+    CHECK(b == printed(std::numeric_limits<T>::min()));
+    b.clear();
+    b.append(std::numeric_limits<T>::max(), ' ', T{0});
+    CHECK(b == printed(std::numeric_limits<T>::max()) + " 0");
+}
+
+static void test_append_integers(){
+    small b;
+
+    check_extremes<signed char>();
+    check_extremes<unsigned char>();
+    check_extremes<short>();
+    check_extremes<int>();
+    check_extremes<long>();
+    check_extremes<long long>();
+    check_extremes<unsigned long long>();
+    check_extremes<std::int64_t>();
+
+    b.append(LLONG_MIN, ':', (signed char)-1, ':', std::uint16_t{65535});
+    CHECK(b == "-9223372036854775808:-1:65535");
+}
+
+static void test_append_pieces(){
+    small b;
+    const char *path = "/index.html?q=1";
+    std::string proto = "HTTP/1.1";
+    char host[32] = "example.org";
+
+    /* Pointer and length: the first 11 bytes, not the pointer followed by a number */
+    b.append(path, 11);
+    CHECK(b == "/index.html");
+    b.clear();
+    b.append(path, 'x');
+    CHECK(b == "/index.html?q=1x");
+    b.clear();
+    b.append("abc", 2);
+    CHECK(b == "ab");
+
+    /* One reserve for the whole line, past the inline capacity */
+    b.clear();
+    b.append("GET ", path, ' ', proto, "\r\nHost: ", host, "\r\n", status_line, 404);
+    CHECK(b == "GET /index.html?q=1 HTTP/1.1\r\nHost: example.org\r\nHTTP/1.1 200 OK\r\n404");
+    CHECK(b.c_str()[b.size()] == '\0');
+
+    /* The bound is an upper bound: the length is what was written */
+    b.clear();
+    b.append(7, 'a', 0u);
+    CHECK(b == "7a0" && b.size() == 3);
+
+    /* An sb::buffer is a piece like any string */
+    small c;
+    c.append("[", b, "]");
+    CHECK(c == "[7a0]");
+}
+
+int main(){
+    test_vector_relocation();
+    test_moved_from();
+    test_std_allocator();
+    test_copy_assignment();
+    test_plus_equal();
+    test_append_integers();
+    test_append_pieces();
+
+    if (failures) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("All C++ wrapper checks passed\n");
+    return 0;
+}
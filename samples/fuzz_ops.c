@@ -0,0 +1,606 @@
+
+/*
+     Fuzz target: decodes the input as a sequence of buffer operations, runs
+     them on two buffers and checks after every step that len, cap, the
+     terminator, the hash cache and the content agree with a plain byte
+     array model. Each buffer can be attached to a recording sink: the model
+     then holds the whole output stream, what the sink received followed by
+     the content. Encoders are checked against scalar references.
+
+     libFuzzer:  cmake -DCMAKE_C_COMPILER=clang -DSB_BUFFER_FUZZ=ON ..  (builds sb_fuzz_ops_libfuzzer)
+     AFL:        CC=afl-clang-fast cmake .. && afl-fuzz -i seeds -o findings ./sb_fuzz_ops @@
+     Standalone: ./sb_fuzz_ops [input files]  (without files: a fixed set of random inputs)
+
+*/
+
+#include "sb_buffer.h"
+#include "sb_codec.h"
+#include "sb_escape.h"
+#include "sb_hash.h"
+#include "sb_pool.h"
+#include "sb_search.h"
+#include "sb_utf8.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Content limit, so that a short input cannot ask for gigabytes */
+#define FUZZ_MAX_LEN (1u << 20)
+
+/* --- Input decoding --- */
+
+typedef struct {
+    const uint8_t *p;
+    size_t n;
+} FuzzInput;
+
+static unsigned take(FuzzInput *in){
+    if (in->n == 0) return 0;
+    in->n--;
+    return *in->p++;
+}
+
+static size_t take_size(FuzzInput *in, size_t max){
+    size_t v = take(in);
+    v = (v << 8) | take(in);
+    return max ? v % (max + 1) : 0;
+}
+
+/* Points at up to len input bytes, consuming them; *got receives the count */
+static const char *take_bytes(FuzzInput *in, size_t len, size_t *got){
+    const char *s = (const char*)in->p;
+    if (len > in->n) len = in->n;
+    in->p += len;
+    in->n -= len;
+    *got = len;
+    return s;
+}
+
+/* --- Model --- */
+
+typedef struct {
+    char *p;
+    size_t len;
+    size_t cap;
+    size_t base;  /* Bytes of the stream already handed to the sink */
+} Model;
+
+static void model_reserve(Model *m, size_t n){
+    if (n <= m->cap) return;
+    m->cap = n * 2;
+    m->p = (char*)realloc(m->p, m->cap);
+    if (!m->p) abort();
+}
+
+static void model_insert(Model *m, size_t pos, const char *s, size_t len){
+    model_reserve(m, m->len + len + 1);
+    memmove(m->p + pos + len, m->p + pos, m->len - pos);
+    if (len) memcpy(m->p + pos, s, len);
+    m->len += len;
+}
+
+static void model_erase(Model *m, size_t pos, size_t n){
+    if (n > m->len - pos) n = m->len - pos;
+    if (n == 0) return;
+    memmove(m->p + pos, m->p + pos + n, m->len - pos - n);
+    m->len -= n;
+}
+
+/* Replaces the content (what follows base) */
+static void model_set(Model *m, const char *s, size_t len){
+    m->len = m->base;
+    model_insert(m, m->base, s, len);
+}
+
+/* --- Recording sink --- */
+
+typedef struct {
+    SB_Sink sink;
+    Model out;  /* Everything written so far */
+    int fail;   /* write_fn refuses while set */
+} Recorder;
+
+static int recorder_write(void *ctx, const char *data, size_t len){
+    Recorder *r = (Recorder*)ctx;
+
+    if (r->fail) return 0;
+    model_insert(&r->out, r->out.len, data, len);
+    return 1;
+}
+
+/* --- Scalar references --- */
+
+/* UTF-16 (host order) to UTF-8; (size_t)-1 on an unpaired surrogate */
+static size_t ref_utf16(const uint16_t *u, size_t count, char *out){
+    size_t i, n = 0;
+
+    for (i = 0; i < count; i++) {
+        uint32_t cp = u[i];
+        if (cp >= 0xD800 && cp <= 0xDFFF) {
+            if (cp > 0xDBFF || i + 1 == count || u[i + 1] < 0xDC00 || u[i + 1] > 0xDFFF) return (size_t)-1;
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (uint32_t)(u[++i] - 0xDC00);
+        }
+        if (cp < 0x80) {
+            out[n++] = (char)cp;
+        } else if (cp < 0x800) {
+            out[n++] = (char)(0xC0 | (cp >> 6));
+            out[n++] = (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out[n++] = (char)(0xE0 | (cp >> 12));
+            out[n++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            out[n++] = (char)(0x80 | (cp & 0x3F));
+        } else {
+            out[n++] = (char)(0xF0 | (cp >> 18));
+            out[n++] = (char)(0x80 | ((cp >> 12) & 0x3F));
+            out[n++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            out[n++] = (char)(0x80 | (cp & 0x3F));
+        }
+    }
+    return n;
+}
+
+static size_t ref_base64(const unsigned char *s, size_t len, int url, char *out){
+    const char *abc = url ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                          : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i, n = 0;
+
+    for (i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)s[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)s[i + 1] << 8;
+        if (i + 2 < len) v |= s[i + 2];
+        out[n++] = abc[v >> 18];
+        out[n++] = abc[(v >> 12) & 63];
+        if (i + 1 < len) out[n++] = abc[(v >> 6) & 63];
+        else if (!url) out[n++] = '=';
+        if (i + 2 < len) out[n++] = abc[v & 63];
+        else if (!url) out[n++] = '=';
+    }
+    return n;
+}
+
+/* kind 0: JSON, 1: HTML, 2: CSV */
+static size_t ref_escape(const char *s, size_t len, int kind, char *out){
+    size_t i, n = 0;
+    int quote = 0;
+
+    if (kind == 2) {
+        for (i = 0; i < len; i++) quote |= s[i] == ',' || s[i] == '"' || s[i] == '\r' || s[i] == '\n';
+        if (quote) out[n++] = '"';
+    }
+    for (i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        const char *e = NULL;
+        if (kind == 0) {
+            switch (c) {
+            case '"': e = "\\\""; break;
+            case '\\': e = "\\\\"; break;
+            case '\b': e = "\\b"; break;
+            case '\f': e = "\\f"; break;
+            case '\n': e = "\\n"; break;
+            case '\r': e = "\\r"; break;
+            case '\t': e = "\\t"; break;
+            default:
+                if (c < 0x20) { n += (size_t)sprintf(out + n, "\\u%04x", c); continue; }
+            }
+        } else if (kind == 1) {
+            switch (c) {
+            case '&': e = "&amp;"; break;
+            case '<': e = "&lt;"; break;
+            case '>': e = "&gt;"; break;
+            case '"': e = "&quot;"; break;
+            case '\'': e = "&#39;"; break;
+            }
+        } else if (c == '"') {
+            e = "\"\"";
+        }
+        if (e) {
+            memcpy(out + n, e, strlen(e));
+            n += strlen(e);
+        } else {
+            out[n++] = (char)c;
+        }
+    }
+    if (quote) out[n++] = '"';
+    return n;
+}
+
+/* Non-overlapping, left to right, on the content (what follows base) */
+static void ref_replace_all(Model *m, const char *from, size_t flen, const char *to, size_t tlen){
+    Model r;
+    size_t i = m->base;
+
+    memset(&r, 0, sizeof(r));
+    while (i < m->len) {
+        if (m->len - i >= flen && memcmp(m->p + i, from, flen) == 0) {
+            model_insert(&r, r.len, to, tlen);
+            i += flen;
+        } else {
+            model_insert(&r, r.len, m->p + i, 1);
+            i++;
+        }
+    }
+    model_set(m, r.p, r.len);
+    free(r.p);
+}
+
+/* --- Invariants --- */
+
+#define FUZZ_CHECK(cond) do { \
+        if (!(cond)) { fprintf(stderr, "invariant failed at op %u: %s\n", op, #cond); abort(); } \
+    } while (0)
+
+static void check(SB_Buffer *b, Model *m, Recorder *rec, unsigned op){
+    /* What the sink received since the last step continues the stream */
+    FUZZ_CHECK(rec->out.len >= m->base && rec->out.len <= m->len);
+    FUZZ_CHECK(rec->out.len == m->base || memcmp(rec->out.p + m->base, m->p + m->base, rec->out.len - m->base) == 0);
+    m->base = rec->out.len;
+
+    FUZZ_CHECK(sb_buffer_isbuffer(b));
+    FUZZ_CHECK(b->len == m->len - m->base);
+    FUZZ_CHECK(sb_buffer_get_len(b) == b->len);
+    FUZZ_CHECK(b->len <= b->cap - SB_BUFFER_TAIL(b));
+    FUZZ_CHECK(b->len == 0 || memcmp(b->str, m->p + m->base, b->len) == 0);
+    if (SB_BUFFER_TAIL(b)) FUZZ_CHECK(b->str[b->len] == '\0');
+    if (b->str == b->init) FUZZ_CHECK(b->cap == SB_BUFFER_INLINE_LIMIT(b) && b->head == 0);
+    if (b->sink) FUZZ_CHECK(b->sink == &rec->sink);
+    else FUZZ_CHECK(b->alloc != NULL);
+    FUZZ_CHECK(sb_buffer_data(b) == b->str);
+
+    /* A cached hash must describe the current content */
+    if (b->hash) {
+        uint64_t h = b->hash;
+        b->hash = 0;
+        FUZZ_CHECK(sb_buffer_hash(b) == h);
+    }
+}
+
+/* --- Operations --- */
+
+static char pattern[4096];
+
+static void run_op(SB_Buffer *bufs[2], Model models[2], Recorder recs[2], FuzzInput *in, unsigned op){
+    unsigned sel = take(in);
+    SB_Buffer *b = bufs[sel & 1], *other = bufs[~sel & 1];
+    Model *m = &models[sel & 1], *om = &models[~sel & 1];
+    Recorder *rec = &recs[sel & 1];
+    size_t room = FUZZ_MAX_LEN - m->len, content = m->len - m->base;
+    size_t n, got, pos;
+    const char *s;
+    char tmp[64], ref[400];
+    int ok;
+
+    switch (take(in) % 31) {
+    case 0: /* Input bytes */
+        s = take_bytes(in, take(in), &got);
+        if (got <= room && sb_buffer_add_lstring(b, s, got)) model_insert(m, m->len, s, got);
+        break;
+    case 1: /* Larger pattern run */
+        n = take_size(in, sizeof(pattern));
+        if (n <= room && sb_buffer_add_lstring(b, pattern, n)) model_insert(m, m->len, pattern, n);
+        break;
+    case 2: /* Inline fast paths, falling back as the macros do */
+        n = take(in) % 64;
+        if (n > room) break;
+        if (b->flags & SB_BUFFER_BINARY) ok = sb_buffer_add_data_fast(b, pattern, n);
+        else ok = sb_buffer_add_lstring_fast(b, pattern, n);
+        if (ok) model_insert(m, m->len, pattern, n);
+        break;
+    case 3:
+        n = (size_t)snprintf(tmp, sizeof(tmp), "%u-%s-%d", take(in), "fmt", -(int)take(in));
+        if (n <= room && sb_buffer_appendf(b, "%s", tmp)) model_insert(m, m->len, tmp, n);
+        break;
+    case 4: {
+        uint64_t v = ((uint64_t)take(in) << 56) | ((uint64_t)take(in) << 28) | take(in);
+        n = (size_t)snprintf(tmp, sizeof(tmp), "%llu", (unsigned long long)v);
+        if (n <= room && sb_buffer_add_u64(b, v)) model_insert(m, m->len, tmp, n);
+        break;
+    }
+    case 5:
+        n = take_size(in, 65536);
+        if (sb_buffer_reserve(b, n)) FUZZ_CHECK(b->cap - SB_BUFFER_TAIL(b) >= n);
+        break;
+    case 6:
+        if (sb_buffer_shrink_to_fit(b) && content + SB_BUFFER_TAIL(b) <= SB_BUFFER_INLINE_LIMIT(b)) FUZZ_CHECK(b->str == b->init);
+        break;
+    case 7:
+        sb_buffer_clear(b);
+        m->len = m->base;
+        break;
+    case 8:
+        sb_buffer_reset(b);
+        m->len = m->base;
+        FUZZ_CHECK(b->str == b->init);
+        break;
+    case 9:
+        n = take_size(in, content + 8);
+        sb_buffer_consume(b, n);
+        model_erase(m, m->base, n);
+        break;
+    case 10:
+        pos = take_size(in, content);
+        s = take_bytes(in, take(in) % 32, &got);
+        if (got <= room && sb_buffer_insert(b, pos, s, got)) model_insert(m, m->base + pos, s, got);
+        break;
+    case 11:
+        pos = take_size(in, content);
+        n = take(in) == 0xFF ? SB_BUFFER_NPOS : take_size(in, 4096);
+        if (sb_buffer_erase(b, pos, n)) model_erase(m, m->base + pos, n);
+        break;
+    case 12:
+        s = take_bytes(in, take(in) % 32, &got);
+        if (got <= room && sb_buffer_prepend(b, s, got)) model_insert(m, m->base, s, got);
+        break;
+    case 13:
+        sb_buffer_compact(b);
+        FUZZ_CHECK(b->head == 0);
+        break;
+    case 14: /* On failure (a refusing sink) dest is left empty */
+        if (content > FUZZ_MAX_LEN - om->base) break;
+        if (sb_buffer_copy(b, other)) model_set(om, m->p + m->base, content);
+        else om->len = om->base;
+        break;
+    case 15:
+        if (content > FUZZ_MAX_LEN - om->base) break;
+        if (sb_buffer_move(b, other)) {
+            model_set(om, m->p + m->base, content);
+            m->len = m->base;
+        } else {
+            om->len = om->base;
+        }
+        break;
+    case 16:
+        sb_buffer_set_binary(b, take(in) & 1);
+        break;
+    case 17: { /* Zero-copy write of part of what was prepared */
+        char *out;
+        n = take_size(in, sizeof(pattern) - 7);
+        if (n > room) break;
+        out = sb_buffer_prepare(b, n);
+        if (!out) break;
+        got = n ? take_size(in, n) : 0;
+        memcpy(out, pattern + 7, got);
+        if (sb_buffer_commit(b, got)) model_insert(m, m->len, pattern + 7, got);
+        break;
+    }
+    case 18:
+        if (sb_buffer_pool_acquire(b, take_size(in, 20000))) FUZZ_CHECK(b->cap >= content + SB_BUFFER_TAIL(b));
+        if (take(in) & 1) {
+            sb_buffer_pool_release(b);
+            m->len = m->base;
+        }
+        break;
+    case 19:
+        s = take_bytes(in, take(in), &got);
+        if (got > room) break;
+        ok = sb_buffer_add_utf8_validated(b, s, got);
+        FUZZ_CHECK(ok == sb_utf8_valid(s, got));
+        if (ok) model_insert(m, m->len, s, got);
+        break;
+    case 20: {
+        uint16_t units[64] = { 0 };
+        size_t i, count = take(in) % 64;
+        for (i = 0; i < count; i++) units[i] = (uint16_t)((take(in) << 8) | take(in));
+        if (count * 3 > room) break;
+        n = ref_utf16(units, count, ref);
+        ok = sb_buffer_add_utf16_as_utf8(b, units, count);
+        if (n == (size_t)-1) FUZZ_CHECK(!ok);
+        else if (ok) model_insert(m, m->len, ref, n);
+        break;
+    }
+    case 21:
+        s = take_bytes(in, take(in) % 64, &got);
+        if (got * 2 <= room && sb_buffer_add_hex(b, s, got)) {
+            size_t i;
+            for (i = 0; i < got; i++) {
+                snprintf(tmp, sizeof(tmp), "%02x", (unsigned char)s[i]);
+                model_insert(m, m->len, tmp, 2);
+            }
+        }
+        break;
+    case 22: {
+        SB_Slice parts[8];
+        size_t i, count = take(in) % 8, total = 0;
+        memset(parts, 0, sizeof(parts));
+        for (i = 0; i < count; i++) {
+            parts[i].base = pattern + take(in);
+            parts[i].len = take(in);
+            total += parts[i].len;
+        }
+        if (total <= room && sb_buffer_add_many(b, parts, count)) {
+            for (i = 0; i < count; i++) model_insert(m, m->len, (const char*)parts[i].base, parts[i].len);
+        }
+        break;
+    }
+    case 23: { /* Attach (or detach) the recording sink */
+        SB_Sink *prev = b->sink;
+        if (take(in) % 4 == 0) {
+            FUZZ_CHECK(sb_buffer_set_sink(b, NULL, 0) && b->sink == NULL);
+            break;
+        }
+        n = take_size(in, 600); /* 0: SB_BUFFER_SINK_HIGH_WATER */
+        if (sb_buffer_set_sink(b, &rec->sink, n)) {
+            size_t size = (n ? n : SB_BUFFER_SINK_HIGH_WATER) + SB_BUFFER_TAIL(b);
+            FUZZ_CHECK(b->sink == &rec->sink && rec->sink.high_water + SB_BUFFER_TAIL(b) == size);
+            if (size <= b->inline_cap) FUZZ_CHECK(b->str == b->init && b->cap == size);
+            else FUZZ_CHECK(b->str != b->init && b->cap + b->head == size);
+        } else {
+            /* Only the flush of oversized content can fail: nothing changed */
+            FUZZ_CHECK(rec->fail && b->sink == prev);
+        }
+        break;
+    }
+    case 24: /* Flush, after (un)setting the failure mode of the sink */
+        rec->fail = (take(in) & 3) == 0;
+        ok = sb_buffer_flush(b);
+        if (b->sink == NULL || !rec->fail) FUZZ_CHECK(ok);
+        if (b->sink && ok) FUZZ_CHECK(b->len == 0);
+        break;
+    case 25: {
+        const char *to;
+        size_t flen = 1 + take(in) % 3, tlen;
+        size_t at = take(in);
+        to = take_bytes(in, take(in) % 8, &tlen);
+        if (tlen > flen && (content / flen) * (tlen - flen) > room) break;
+        if (sb_buffer_replace_all(b, pattern + at, flen, to, tlen)) ref_replace_all(m, pattern + at, flen, to, tlen);
+        break;
+    }
+    case 26: { /* base64 into the buffer, then decoded back */
+        SB_Buffer SB_INIT(dec);
+        int url = take(in) & 1;
+        s = take_bytes(in, take(in) % 64, &got);
+        n = ref_base64((const unsigned char*)s, got, url, ref);
+        if (n > room) { sb_buffer_finalize(&dec); break; }
+        ok = url ? sb_buffer_add_base64url(b, s, got) : sb_buffer_add_base64(b, s, got);
+        if (ok) {
+            model_insert(m, m->len, ref, n);
+            FUZZ_CHECK(sb_buffer_add_base64_decoded(&dec, ref, n));
+            FUZZ_CHECK(dec.len == got && memcmp(dec.str, s, got) == 0);
+        }
+        sb_buffer_finalize(&dec);
+        break;
+    }
+    case 27: {
+        int kind = (int)(take(in) % 3);
+        s = take_bytes(in, take(in) % 64, &got);
+        n = ref_escape(s, got, kind, ref);
+        if (n > room) break;
+        ok = kind == 0 ? sb_buffer_add_json_escaped(b, s, got)
+           : kind == 1 ? sb_buffer_add_html_escaped(b, s, got)
+           : sb_buffer_add_csv_quoted(b, s, got);
+        if (ok) model_insert(m, m->len, ref, n);
+        break;
+    }
+    case 28: {
+        uint64_t u = 0;
+        size_t i;
+        for (i = 0; i < 8; i++) u = (u << 8) | take(in);
+        /* Mostly small magnitudes, sometimes the extremes */
+        if (take(in) & 1) u = (uint64_t)((int64_t)u >> (take(in) % 64));
+        n = (size_t)snprintf(tmp, sizeof(tmp), "%lld", (long long)(int64_t)u);
+        if (n <= room && sb_buffer_add_i64(b, (int64_t)u)) model_insert(m, m->len, tmp, n);
+        break;
+    }
+    case 29: {
+        uint64_t u = 0;
+        double v;
+        int dec = (int)(take(in) % (SB_BUFFER_DOUBLE_MAX_DECIMALS + 1));
+        size_t i;
+        for (i = 0; i < 8; i++) u = (u << 8) | take(in);
+        memcpy(&v, &u, sizeof(v));
+        /* Finite values below 1e18 only: the fixed notation shared with printf */
+        if (v != v || v >= 1e18 || v <= -1e18) break;
+        n = (size_t)snprintf(tmp, sizeof(tmp), "%.*f", dec, v);
+        if (n <= room && sb_buffer_add_double(b, v, dec)) model_insert(m, m->len, tmp, n);
+        break;
+    }
+    default:
+        sb_buffer_set_growth(b, (SB_Growth)(take(in) % 4));
+        (void)sb_buffer_hash(b);
+        s = sb_buffer_get_str(b);
+        FUZZ_CHECK(s[content] == '\0');
+        break;
+    }
+
+    check(bufs[0], &models[0], &recs[0], op);
+    check(bufs[1], &models[1], &recs[1], op);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size){
+    SB_Buffer SB_INIT(a);
+    SB_Buffer16 small;
+    SB_Buffer *bufs[2];
+    Model models[2];
+    Recorder recs[2];
+    FuzzInput in;
+    unsigned op = 0;
+    size_t i;
+
+    if (!pattern[0]) {
+        for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)('A' + i % 57);
+    }
+
+    sb_buffer_init_inline(SB_BUFFER_AS(&small), sizeof(small.init));
+    bufs[0] = &a;
+    bufs[1] = SB_BUFFER_AS(&small);
+    memset(models, 0, sizeof(models));
+    memset(recs, 0, sizeof(recs));
+    for (i = 0; i < 2; i++) {
+        recs[i].sink.write_fn = recorder_write;
+        recs[i].sink.ctx = &recs[i];
+    }
+    in.p = data;
+    in.n = size;
+
+    while (in.n) run_op(bufs, models, recs, &in, op++);
+
+    sb_buffer_finalize(&a);
+    sb_buffer_finalize(SB_BUFFER_AS(&small));
+    for (i = 0; i < 2; i++) {
+        free(models[i].p);
+        free(recs[i].out.p);
+    }
+    return 0;
+}
+
+#if !defined(SB_FUZZ_LIBFUZZER)
+
+/* xorshift64*: deterministic inputs for the test run */
+static uint64_t fuzz_rng = 0x9E3779B97F4A7C15ull;
+
+static uint64_t fuzz_next(void){
+    fuzz_rng ^= fuzz_rng >> 12;
+    fuzz_rng ^= fuzz_rng << 25;
+    fuzz_rng ^= fuzz_rng >> 27;
+    return fuzz_rng * 2685821657736338717ull;
+}
+
+static int run_file(const char *path){
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    size_t len = 0, cap = 0, n;
+
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    do {
+        if (len == cap) {
+            cap = cap ? cap * 2 : 65536;
+            data = (uint8_t*)realloc(data, cap);
+            if (!data) abort();
+        }
+        n = fread(data + len, 1, cap - len, f);
+        len += n;
+    } while (n);
+    fclose(f);
+
+    LLVMFuzzerTestOneInput(data, len);
+    free(data);
+    return 1;
+}
+
+int main(int argc, char **argv){
+    static uint8_t data[4096];
+    int i, runs = 3000;
+    size_t j, len;
+
+    if (argc > 1) {
+        for (i = 1; i < argc; i++) {
+            if (!run_file(argv[i])) return 1;
+        }
+        return 0;
+    }
+
+    for (i = 0; i < runs; i++) {
+        len = (size_t)(fuzz_next() % sizeof(data));
+        for (j = 0; j < len; j++) data[j] = (uint8_t)(fuzz_next() >> 56);
+        LLVMFuzzerTestOneInput(data, len);
+    }
+    printf("%d random inputs passed\n", runs);
+    return 0;
+}
+
+#endif
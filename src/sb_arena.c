@@ -0,0 +1,158 @@
+#include "sb_arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Offset of the data area inside a chunk (keeps the data aligned) */
+#define SB_ARENA_HDR \
+    ((sizeof(SB_ArenaChunk) + SB_ARENA_ALIGN - 1) & ~(size_t)(SB_ARENA_ALIGN - 1))
+
+#define SB_ARENA_DATA(c) ((char*)(c) + SB_ARENA_HDR)
+
+static size_t sb_arena_align(size_t n){
+    return (n + SB_ARENA_ALIGN - 1) & ~(size_t)(SB_ARENA_ALIGN - 1);
+}
+
+/* --- Allocator Hooks --- */
+
+static void *sb_arena_hook_alloc(void *ctx, size_t size){
+    return sb_arena_alloc((SB_Arena*)ctx, size);
+}
+
+static void *sb_arena_hook_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size){
+    SB_Arena *a = (SB_Arena*)ctx;
+    SB_ArenaChunk *c = a->head;
+    void *novo_ptr;
+
+    if (c && (char*)ptr + old_size == SB_ARENA_DATA(c) + c->used) {
+        /* The block sits at the top of the arena: grow (or shrink) in place */
+        size_t start = (size_t)((char*)ptr - SB_ARENA_DATA(c));
+        if (new_size <= c->size - start) {
+            c->used = start + new_size;
+            return ptr;
+        }
+    }
+
+    if (new_size <= old_size) return ptr;
+
+    novo_ptr = sb_arena_alloc(a, new_size);
+    if (!novo_ptr) return NULL;
+
+    memcpy(novo_ptr, ptr, old_size);
+    return novo_ptr;
+}
+
+static void sb_arena_hook_free(void *ctx, void *ptr, size_t size){
+    SB_Arena *a = (SB_Arena*)ctx;
+    SB_ArenaChunk *c = a->head;
+
+    /* Only the top block can be given back; the rest goes with the arena */
+    if (c && (char*)ptr + size == SB_ARENA_DATA(c) + c->used) {
+        c->used = (size_t)((char*)ptr - SB_ARENA_DATA(c));
+    }
+}
+
+/* --- Arena --- */
+
+/**
+ * @brief Initializes an empty arena.
+ */
+int sb_arena_init(SB_Arena *a, size_t chunk_size){
+    if (a == NULL) return 0;
+
+    a->allocator.alloc_fn = sb_arena_hook_alloc;
+    a->allocator.realloc_fn = sb_arena_hook_realloc;
+    a->allocator.free_fn = sb_arena_hook_free;
+    a->allocator.ctx = a;
+    a->head = NULL;
+    a->chunk_size = chunk_size ? chunk_size : SB_ARENA_CHUNK_SIZE;
+
+    return 1;
+}
+
+/**
+ * @brief Returns the allocator vtable of the arena.
+ */
+const SB_Allocator *sb_arena_allocator(SB_Arena *a){
+    if (a == NULL) return NULL;
+    return &a->allocator;
+}
+
+/**
+ * @brief Allocates size bytes from the top of the arena.
+ */
+void *sb_arena_alloc(SB_Arena *a, size_t size){
+    SB_ArenaChunk *c;
+    size_t start;
+
+    if (a == NULL) return NULL;
+
+    c = a->head;
+    if (c) {
+        start = sb_arena_align(c->used);
+        if (start <= c->size && size <= c->size - start) {
+            c->used = start + size;
+            return SB_ARENA_DATA(c) + start;
+        }
+    }
+
+    /* Open a new chunk, large enough for oversized requests */
+    {
+        size_t data_size = size > a->chunk_size ? sb_arena_align(size) : a->chunk_size;
+
+        if (data_size > (size_t)-1 - SB_ARENA_HDR) return NULL;
+
+        c = (SB_ArenaChunk*)malloc(SB_ARENA_HDR + data_size);
+        if (!c) return NULL;
+
+        c->next = a->head;
+        c->size = data_size;
+        c->used = size;
+        a->head = c;
+    }
+
+    return SB_ARENA_DATA(c);
+}
+
+/**
+ * @brief Forgets every allocation, keeping the first base-size chunk for reuse.
+ */
+int sb_arena_reset(SB_Arena *a){
+    SB_ArenaChunk *c, *next, *keep = NULL;
+
+    if (a == NULL) return 0;
+
+    /* The list runs newest first: the last base-size chunk seen is the first one opened */
+    for (c = a->head; c; c = next) {
+        next = c->next;
+        if (c->size != a->chunk_size) {
+            free(c); /* Oversized dedicated chunk */
+            continue;
+        }
+        if (keep) free(keep);
+        keep = c;
+    }
+
+    if (keep) {
+        keep->next = NULL;
+        keep->used = 0;
+    }
+    a->head = keep;
+    return 1;
+}
+
+/**
+ * @brief Releases all the chunks in bulk.
+ */
+int sb_arena_finalize(SB_Arena *a){
+    SB_ArenaChunk *c, *next;
+
+    if (a == NULL) return 0;
+
+    for (c = a->head; c; c = next) {
+        next = c->next;
+        free(c);
+    }
+
+    a->head = NULL;
+    return 1;
+}
@@ -1,7 +1,52 @@
 #include "sb_buffer.h"
+#include "sb_stats_hooks.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h> /* Keep for fprintf in the macro */
+#include <stdarg.h>
+
+/* The header (everything before init) must fit in one 64-byte cache line:
+   keep rarely used state out of SB_BUFFER_HEADER */
+typedef char sb_buffer_header_fits_a_line[offsetof(SB_Buffer, init) <= 64 ? 1 : -1];
+
+/* --- Allocator Hooks --- */
+
+static void *sb_malloc_alloc(void *ctx, size_t size){
+    (void)ctx;
+    return malloc(size);
+}
+
+static void *sb_malloc_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size){
+    (void)ctx; (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+static void sb_malloc_free(void *ctx, void *ptr, size_t size){
+    (void)ctx; (void)size;
+    free(ptr);
+}
+
+/* The standard library allocator (default) */
+const SB_Allocator sb_buffer_malloc_allocator = {
+    sb_malloc_alloc, sb_malloc_realloc, sb_malloc_free, NULL
+};
+
+/* Allocator assigned to buffers at initialization */
+static const SB_Allocator *sb_default_allocator = &sb_buffer_malloc_allocator;
+
+/**
+ * @brief Sets the allocator used by buffers initialized from now on.
+ */
+void sb_buffer_set_default_allocator(const SB_Allocator *a){
+    sb_default_allocator = a ? a : &sb_buffer_malloc_allocator;
+}
+
+/**
+ * @brief Returns the allocator assigned to newly initialized buffers.
+ */
+const SB_Allocator *sb_buffer_get_default_allocator(void){
+    return sb_default_allocator;
+}
 
 /* --- Initialization --- */
 
@@ -11,15 +56,28 @@
  * @return int 1 on success, 0 if the input pointer is NULL.
  */
 int sb_buffer_init(SB_Buffer *b) {
+    return sb_buffer_init_inline(b, SB_BUFFER_INITIAL_CAP);
+}
+
+/**
+ * @brief Initializes a buffer with an init array of inline_cap bytes.
+ */
+int sb_buffer_init_inline(SB_Buffer *b, size_t inline_cap) {
     /* Always check if the input pointer is NULL first */
-    if (b == NULL) return 0; 
+    if (b == NULL || inline_cap == 0 || inline_cap > UINT32_MAX) return 0; 
     
     /* Set the signature: Must be set before any other function is called */
     b->magic = SB_BUFFER_MAGIC;
+    b->flags = SB_BUFFER_DEFAULT_GROWTH;
+    b->alloc = sb_default_allocator;
+    b->sink = NULL;
+    b->inline_cap = (uint32_t)inline_cap;
+    b->head = 0;
+    b->hash = 0;
     
     /* Initialization: Pointer points to the internal stack buffer (SSO) */
     b->len = 0;
-    b->cap = SB_BUFFER_INITIAL_CAP;
+    b->cap = inline_cap;
     b->str = b->init;
     
     /* Ensure the string starts empty (null terminated) */
@@ -30,6 +88,154 @@ int sb_buffer_init(SB_Buffer *b) {
 
 /* --- Core Logic --- */
 
+/**
+ * @brief Rounds n up to the next jemalloc-style size class
+ * (four classes per power of two).
+ */
+static size_t sb_buffer_size_class(size_t n){
+    size_t step = 16;
+    
+    if (n <= 64) return (n + 15) & ~(size_t)15;
+    
+    /* step = 1/4 of the power of two just below n */
+    while ((step << 3) < n) step <<= 1;
+    
+    return (n + step - 1) & ~(step - 1);
+}
+
+/**
+ * @brief Computes the next capacity (never less than need) for the given policy.
+ */
+static size_t sb_buffer_next_cap(unsigned policy, size_t cap, size_t need){
+    size_t nova_cap = cap;
+    
+    switch (policy) {
+    case SB_GROWTH_1_5X:
+        while (nova_cap < need) nova_cap += nova_cap / 2 + 1;
+        return nova_cap;
+        
+    case SB_GROWTH_PAGE:
+        nova_cap = cap + cap / 2;
+        if (nova_cap < need) nova_cap = need;
+        if (nova_cap < SB_BUFFER_PAGE_SIZE) return nova_cap;
+        return (nova_cap + SB_BUFFER_PAGE_SIZE - 1) & ~(size_t)(SB_BUFFER_PAGE_SIZE - 1);
+        
+    case SB_GROWTH_SIZE_CLASS:
+        nova_cap = cap + cap / 4;
+        if (nova_cap < need) nova_cap = need;
+        return sb_buffer_size_class(nova_cap);
+        
+    default:
+        break;
+    }
+    
+    /* Default strategy: doubles until sufficient. */
+    nova_cap = cap;
+    while (nova_cap < need) nova_cap *= 2;
+    return nova_cap;
+}
+
+/**
+ * @brief Moves the content to the start of the block, turning the head back into capacity.
+ */
+static void sb_buffer_rewind(SB_Buffer *b){
+    memmove(b->str - b->head, b->str, b->len + SB_BUFFER_TAIL(b));
+    b->str -= b->head;
+    b->cap += b->head;
+    b->head = 0;
+}
+
+/**
+ * @brief Moves the content into a block of exactly nova_cap bytes.
+ * nova_cap must be at least b->len + SB_BUFFER_TAIL(b) (room for the terminator).
+ */
+static int sb_buffer_set_cap(SB_Buffer *b, size_t nova_cap){
+    
+    /* The allocator sees whole blocks: give back the consumed head first */
+    if (b->head) sb_buffer_rewind(b);
+    
+    if (b->str != b->init){ 
+        /* Already on the heap: now realloc it */
+        char *novo_ptr = (char*)b->alloc->realloc_fn(b->alloc->ctx, b->str, b->cap, nova_cap);
+        if (!novo_ptr) { return 0; } 
+        SB_STATS_SET_CAP(0, novo_ptr != b->str, b->len + SB_BUFFER_TAIL(b), nova_cap);
+        b->str = novo_ptr;
+        
+    } else { 
+        /* Currently using b->init: Migrate to the heap */
+        char *novo_ptr = (char*)b->alloc->alloc_fn(b->alloc->ctx, nova_cap);
+        if (!novo_ptr) { return 0; }
+        
+        /* Copy the old content (and terminator) to the new heap area */
+        memcpy(novo_ptr, b->init, b->len + SB_BUFFER_TAIL(b));
+        SB_STATS_SET_CAP(1, 1, b->len + SB_BUFFER_TAIL(b), nova_cap);
+        
+        b->str = novo_ptr;
+    }
+    
+    b->cap = nova_cap;
+    return 1;
+}
+
+/**
+ * @brief Makes room for extra more bytes (plus terminator) in the storage itself.
+ */
+static int sb_buffer_grow_block(SB_Buffer *b, size_t extra){
+    size_t need;
+    
+    /* Refuse sizes that would overflow size_t */
+    if (extra >= (size_t)-1 / 2 - b->len) return 0;
+    
+    /* +1 ensures space for the null terminator (none in binary mode). */
+    need = b->len + extra + SB_BUFFER_TAIL(b);
+    
+    /* Reclaim the consumed head when moving the content costs no more than was consumed */
+    if (b->head >= b->len && need <= b->cap + b->head) {
+        sb_buffer_rewind(b);
+        return 1;
+    }
+    
+    return sb_buffer_set_cap(b, sb_buffer_next_cap(b->flags & SB_BUFFER_GROWTH_MASK,
+                                                   b->cap + b->head, need));
+}
+
+/**
+ * @brief Grows the capacity so that extra more bytes (plus terminator) fit.
+ */
+static int sb_buffer_grow(SB_Buffer *b, size_t extra){
+    
+    /* Sink-backed: make room by flushing; grow only for a piece larger than the buffer */
+    if (b->sink) {
+        if (!sb_buffer_flush(b)) return 0;
+        if (extra <= SB_BUFFER_ROOM(b)) return 1;
+    }
+    
+    return sb_buffer_grow_block(b, extra);
+}
+
+/**
+ * @brief Slow path of the append: grows, then appends (no validation).
+ */
+int sb_buffer_add_lstring_slow(SB_Buffer *b, const char *s, size_t len){
+    
+    /* Sink-backed and larger than the whole buffer: bypass it */
+    if (b->sink && len > b->cap - SB_BUFFER_TAIL(b)) {
+        return sb_buffer_flush(b) && b->sink->write_fn(b->sink->ctx, s, len);
+    }
+    
+    /* Check if capacity needs to be increased */
+    if (len > SB_BUFFER_ROOM(b) && !sb_buffer_grow(b, len)) return 0;
+    
+    /* Appends the new string at the end */
+    memcpy(b->str + b->len, s, len);
+    
+    /* Updates the length and ensures null termination */
+    b->len += len;
+    SB_BUFFER_TERMINATE(b);
+    b->hash = 0;
+    return 1;
+}
+
 /**
  * @brief Adds a string of known length to the buffer.
  */
@@ -38,45 +244,560 @@ int sb_buffer_add_lstring(SB_Buffer *b, const char *s, size_t len){
     /* Safety check using macro defined in buffer.h */
     CHECK_SB_BUFFER_POINTER_RET(b, 0);
     
-    size_t sobrando = b->cap - b->len;
+    if (b->flags & SB_BUFFER_BINARY) return sb_buffer_add_data_fast(b, s, len);
+    return sb_buffer_add_lstring_fast(b, s, len);
+}
+
+/**
+ * @brief Appends several pieces with a single capacity check.
+ */
+int sb_buffer_add_many(SB_Buffer *b, const SB_Slice *parts, size_t count){
+    size_t total = 0;
+    size_t i;
+    char *p;
     
-    /* Check if capacity needs to be increased */
-    if( len >= sobrando){ 
-        
-        size_t nova_cap = b->cap;
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (parts == NULL && count) return 0;
+    
+    /* First pass: total length (refusing overflow) */
+    for (i = 0; i < count; i++) {
+        if (parts[i].len > (size_t)-1 / 2 - total) return 0;
+        total += parts[i].len;
+    }
+    
+    /* Sink-backed and larger than the whole buffer: piece by piece from an
+       empty buffer, so that until the first write everything is undoable */
+    if (b->sink && total > b->cap - SB_BUFFER_TAIL(b)) {
+        int wrote = 0;
         
-        /* Growth strategy: doubles until sufficient. */
-        /* +1 ensures space for the null terminator. */
-        while (nova_cap <= b->len + len + 1) { 
-            nova_cap *= 2; 
+        if (!sb_buffer_flush(b)) return 0;
+        for (i = 0; i < count; i++) {
+            const char *s = (const char*)parts[i].base;
+            size_t len = parts[i].len;
+            
+            if (len > SB_BUFFER_ROOM(b)) {
+                if (b->len) {
+                    if (!sb_buffer_flush(b)) break;
+                    wrote = 1;
+                }
+                if (len > b->cap - SB_BUFFER_TAIL(b)) {
+                    if (!b->sink->write_fn(b->sink->ctx, s, len)) break;
+                    wrote = 1;
+                    continue;
+                }
+            }
+            memcpy(b->str + b->len, s, len);
+            b->len += len;
         }
         
-        if (b->str != b->init){ 
-            /* Already malloc'd: now realloc it */
-            char *novo_ptr = (char*)realloc(b->str, nova_cap);
-            if (!novo_ptr) { return 0; } 
-            b->str = novo_ptr;
-            
-        } else { 
-            /* Currently using b->init: Migrate to malloc */
-            char *novo_ptr = (char*)malloc(nova_cap);
-            if (!novo_ptr) { return 0; }
-            
-            /* Copy the old content to the new heap area */
-            memcpy(novo_ptr, b->init, b->len);
-            
-            b->str = novo_ptr;
+        /* The first write failed: none of the pieces went out, drop them all */
+        if (i < count && !wrote) b->len = 0;
+        SB_BUFFER_TERMINATE(b);
+        b->hash = 0;
+        return i == count;
+    }
+    
+    /* Grow at most once */
+    if (total > SB_BUFFER_ROOM(b) && !sb_buffer_grow(b, total)) return 0;
+    
+    /* Second pass: copy everything */
+    p = b->str + b->len;
+    for (i = 0; i < count; i++) {
+        memcpy(p, parts[i].base, parts[i].len);
+        p += parts[i].len;
+    }
+    
+    b->len += total;
+    SB_BUFFER_TERMINATE(b);
+    b->hash = 0;
+    return 1;
+}
+
+/* --- Zero-Copy Writes --- */
+
+/**
+ * @brief Ensures room for n more bytes and returns where to write them.
+ */
+char *sb_buffer_prepare(SB_Buffer *b, size_t n){
+    CHECK_SB_BUFFER_POINTER_RET(b, NULL);
+    
+    if (n > SB_BUFFER_ROOM(b) && !sb_buffer_grow(b, n)) return NULL;
+    
+    return b->str + b->len;
+}
+
+/**
+ * @brief Accounts for bytes written in place after sb_buffer_prepare().
+ */
+int sb_buffer_commit(SB_Buffer *b, size_t written){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    /* Never step over the space reserved for the terminator */
+    if (written > SB_BUFFER_ROOM(b)) return 0;
+    
+    b->len += written;
+    SB_BUFFER_TERMINATE(b);
+    b->hash = 0;
+    return 1;
+}
+
+/* --- Formatted and Numeric Appends --- */
+
+/**
+ * @brief printf-style append, formatting straight into the spare capacity.
+ */
+int sb_buffer_vappendf(SB_Buffer *b, const char *fmt, va_list ap){
+    va_list ap2;
+    int n;
+    
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    /* First attempt: format in place using what is left of the capacity */
+    va_copy(ap2, ap);
+    n = vsnprintf(b->str + b->len, b->cap - b->len, fmt, ap2);
+    va_end(ap2);
+    
+    if (n < 0) { SB_BUFFER_TERMINATE(b); return 0; }
+    
+    if ((size_t)n >= b->cap - b->len) {
+        /* Did not fit: grow once to the exact size (vsnprintf always terminates), then format again */
+        if (!sb_buffer_grow(b, (size_t)n + 1 - SB_BUFFER_TAIL(b))) { SB_BUFFER_TERMINATE(b); return 0; }
+        
+        va_copy(ap2, ap);
+        n = vsnprintf(b->str + b->len, b->cap - b->len, fmt, ap2);
+        va_end(ap2);
+        
+        if (n < 0) { SB_BUFFER_TERMINATE(b); return 0; }
+    }
+    
+    b->len += (size_t)n;
+    b->hash = 0;
+    return 1;
+}
+
+/**
+ * @brief printf-style append (variadic front end of sb_buffer_vappendf).
+ */
+int sb_buffer_appendf(SB_Buffer *b, const char *fmt, ...){
+    va_list ap;
+    int ret;
+    
+    va_start(ap, fmt);
+    ret = sb_buffer_vappendf(b, fmt, ap);
+    va_end(ap);
+    
+    return ret;
+}
+
+/* Two-digit lookup table: "00" .. "99" */
+static const char sb_digits2[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * @brief Writes the decimal digits of v ending right before end; returns the first digit.
+ */
+static char *sb_format_u64(char *end, uint64_t v){
+    char *p = end;
+    
+    while (v >= 100) {
+        unsigned i = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--p = sb_digits2[i + 1];
+        *--p = sb_digits2[i];
+    }
+    if (v >= 10) {
+        unsigned i = (unsigned)v * 2;
+        *--p = sb_digits2[i + 1];
+        *--p = sb_digits2[i];
+    } else {
+        *--p = (char)('0' + v);
+    }
+    
+    return p;
+}
+
+/**
+ * @brief Appends the decimal form of an unsigned 64-bit integer.
+ */
+int sb_buffer_add_u64(SB_Buffer *b, uint64_t v){
+    char tmp[20];
+    char *p;
+    
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    p = sb_format_u64(tmp + sizeof(tmp), v);
+    return sb_buffer_add_lstring_fast(b, p, (size_t)(tmp + sizeof(tmp) - p));
+}
+
+/**
+ * @brief Appends the decimal form of a signed 64-bit integer.
+ */
+int sb_buffer_add_i64(SB_Buffer *b, int64_t v){
+    char tmp[21];
+    char *p;
+    
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    /* Negate in unsigned arithmetic: well defined for INT64_MIN */
+    if (v < 0) {
+        p = sb_format_u64(tmp + sizeof(tmp), (uint64_t)0 - (uint64_t)v);
+        *--p = '-';
+    } else {
+        p = sb_format_u64(tmp + sizeof(tmp), (uint64_t)v);
+    }
+    
+    return sb_buffer_add_lstring_fast(b, p, (size_t)(tmp + sizeof(tmp) - p));
+}
+
+/* Powers of ten for the fractional digits */
+static const uint64_t sb_pow10[SB_BUFFER_DOUBLE_MAX_DECIMALS + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL
+};
+
+/**
+ * @brief Rounding error of the product p = a * b: a * b == p + error exactly
+ * (Dekker's two-product, so no fma or libm is needed).
+ */
+static double sb_product_error(double a, double b, double p){
+    const double split = 134217729.0; /* 2^27 + 1 */
+    double t, ah, al, bh, bl;
+    
+    t = split * a; ah = t - (t - a); al = a - ah;
+    t = split * b; bh = t - (t - b); bl = b - bh;
+    return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+}
+
+/**
+ * @brief Appends a double with a fixed number of decimals (like "%.*f", locale independent).
+ */
+int sb_buffer_add_double(SB_Buffer *b, double v, int decimals){
+    char tmp[48];
+    char *end = tmp + sizeof(tmp);
+    char *p = end;
+    int neg = 0;
+    uint64_t ipart, fpart, scale;
+    
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (decimals < 0) decimals = 0;
+    if (decimals > SB_BUFFER_DOUBLE_MAX_DECIMALS) decimals = SB_BUFFER_DOUBLE_MAX_DECIMALS;
+    
+    if (v != v) return sb_buffer_add_lstring_fast(b, "nan", 3);
+    if (v < 0 || (v == 0 && 1 / v < 0)) { neg = 1; v = -v; }
+    if (v > 1e300 * 1e300) return neg ? sb_buffer_add_lstring_fast(b, "-inf", 4)
+                                      : sb_buffer_add_lstring_fast(b, "inf", 3);
+    
+    if (v >= 1e18) {
+        /* Beyond the exact integer path: let the C library do it */
+        int n = snprintf(tmp, sizeof(tmp), "%s%.*e", neg ? "-" : "", decimals, v);
+        char *dot;
+        if (n < 0 || (size_t)n >= sizeof(tmp)) return 0;
+        /* Decimal separator must not depend on the locale */
+        for (dot = tmp; *dot; dot++) if (*dot == ',') *dot = '.';
+        return sb_buffer_add_lstring_fast(b, tmp, (size_t)n);
+    }
+    
+    scale = sb_pow10[decimals];
+    ipart = (uint64_t)v;
+    {
+        /* The fraction is exact; its product with scale is scaled + err
+           exactly, so ties are decided on the real value: half to even as
+           printf does for exact ties, the side of err otherwise */
+        double frac = v - (double)ipart;
+        double scaled = frac * (double)scale;
+        double err = sb_product_error(frac, (double)scale, scaled);
+        double rest;
+        fpart = (uint64_t)scaled;
+        rest = scaled - (double)fpart - 0.5;
+        if (rest > 0 || (rest == 0 && (err > 0 || (err == 0 && ((decimals ? fpart : ipart) & 1))))) fpart++;
+    }
+    if (fpart >= scale) { ipart++; fpart -= scale; }
+    
+    if (decimals > 0) {
+        int i;
+        for (i = 0; i < decimals; i++) {
+            *--p = (char)('0' + fpart % 10);
+            fpart /= 10;
         }
+        *--p = '.';
+    }
+    
+    p = sb_format_u64(p, ipart);
+    if (neg) *--p = '-';
+    
+    return sb_buffer_add_lstring_fast(b, p, (size_t)(end - p));
+}
+
+/* --- Capacity Management --- */
+
+/**
+ * @brief Ensures the buffer can hold n bytes of content without growing.
+ */
+int sb_buffer_reserve(SB_Buffer *b, size_t n){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (n >= (size_t)-1 / 2) return 0;
+    n += SB_BUFFER_TAIL(b);
+    
+    /* Already large enough */
+    if (n <= b->cap) return 1;
+    
+    /* Enough once the consumed head is reclaimed */
+    if (n <= b->cap + b->head) {
+        sb_buffer_rewind(b);
+        return 1;
+    }
+    
+    /* The caller knows the final size: allocate exactly, no policy rounding */
+    return sb_buffer_set_cap(b, n);
+}
+
+/**
+ * @brief Releases unused capacity, moving back to the stack area when it fits.
+ */
+int sb_buffer_shrink_to_fit(SB_Buffer *b){
+    size_t need;
+    
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (b->str == b->init) return 1;
+    need = b->len + SB_BUFFER_TAIL(b);
+    
+    if (need <= SB_BUFFER_INLINE_LIMIT(b)) {
+        /* Content fits in the stack area again: migrate back and free */
+        memcpy(b->init, b->str, need);
+        b->alloc->free_fn(b->alloc->ctx, b->str - b->head, b->cap + b->head);
+        b->str = b->init;
+        b->cap = SB_BUFFER_INLINE_LIMIT(b);
+        b->head = 0;
+        return 1;
+    }
+    
+    if (need == b->cap + b->head) return 1;
+    return sb_buffer_set_cap(b, need);
+}
+
+/**
+ * @brief Selects the growth policy used by this buffer.
+ */
+int sb_buffer_set_growth(SB_Buffer *b, SB_Growth policy){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if ((unsigned)policy > SB_GROWTH_SIZE_CLASS) return 0;
+    
+    b->flags = (b->flags & ~(uint32_t)SB_BUFFER_GROWTH_MASK) | (uint32_t)policy;
+    return 1;
+}
+
+/**
+ * @brief Writes the terminator of binary content, growing by one byte if it fills the storage.
+ */
+static int sb_buffer_terminate(SB_Buffer *b){
+    if (b->len == b->cap) {
+        if (b->head) sb_buffer_rewind(b);
+        else if (!sb_buffer_set_cap(b, b->len + 1)) return 0;
+    }
+    b->str[b->len] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Switches the buffer into or out of binary mode.
+ */
+int sb_buffer_set_binary(SB_Buffer *b, int on){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (on) {
+        b->flags |= SB_BUFFER_BINARY;
+    } else {
+        /* Text mode keeps the terminator in place from now on */
+        if ((b->flags & SB_BUFFER_BINARY) && !sb_buffer_terminate(b)) return 0;
+        b->flags &= ~(uint32_t)SB_BUFFER_BINARY;
+    }
+    
+    /* A sink-backed inline buffer still holds high_water bytes in the new mode */
+    if (b->sink && b->str == b->init) b->cap = SB_BUFFER_INLINE_LIMIT(b);
+    return 1;
+}
+
+/**
+ * @brief Switches the allocator of a buffer, migrating heap content if needed.
+ */
+int sb_buffer_set_allocator(SB_Buffer *b, const SB_Allocator *a){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (a == NULL) a = &sb_buffer_malloc_allocator;
+    if (a == b->alloc) return 1;
+    
+    if (b->str != b->init) {
+        /* Move the heap block to storage owned by the new allocator */
+        char *novo_ptr = (char*)a->alloc_fn(a->ctx, b->cap);
+        if (!novo_ptr) return 0;
         
-        b->cap = nova_cap;
+        memcpy(novo_ptr, b->str, b->len + SB_BUFFER_TAIL(b));
+        b->alloc->free_fn(b->alloc->ctx, b->str - b->head, b->cap + b->head);
+        b->str = novo_ptr;
+        b->head = 0;
     }
     
-    /* Appends the new string at the end */
-    memcpy(b->str + b->len, s, len);
+    b->alloc = a;
+    return 1;
+}
+
+/* --- Sinks --- */
+
+/**
+ * @brief Attaches a sink: the buffer flushes instead of growing.
+ */
+int sb_buffer_set_sink(SB_Buffer *b, SB_Sink *sink, size_t high_water){
+    SB_Sink *prev;
+    size_t prev_high_water, size;
     
-    /* Updates the length and ensures null termination */
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (sink == NULL) {
+        /* Growing again: the whole inline array is usable */
+        b->sink = NULL;
+        if (b->str == b->init) b->cap = b->inline_cap;
+        return 1;
+    }
+    if (sink->write_fn == NULL || high_water >= (size_t)-1 / 2) return 0;
+    if (high_water == 0) high_water = SB_BUFFER_SINK_HIGH_WATER;
+    
+    /* Oversized content goes to the new sink before anything changes */
+    if (b->len > high_water) {
+        if (!sink->write_fn(sink->ctx, b->str, b->len)) return 0;
+        sb_buffer_clear(b);
+    }
+    
+    prev = b->sink;
+    prev_high_water = prev ? prev->high_water : 0;
+    b->sink = sink;
+    sink->high_water = high_water;
+    
+    /* Fixed storage of exactly high_water (+ terminator): part of the inline
+       array if it is big enough, else one block of that size */
+    size = high_water + SB_BUFFER_TAIL(b);
+    if (size <= b->inline_cap) {
+        if (b->str != b->init) return sb_buffer_shrink_to_fit(b);
+        b->cap = size;
+        return 1;
+    }
+    if (b->cap + b->head == size || sb_buffer_set_cap(b, size)) return 1;
+    
+    /* No block of that size: back to the previous mode */
+    b->sink = prev;
+    if (prev) prev->high_water = prev_high_water;
+    return 0;
+}
+
+/**
+ * @brief Writes the content to the sink and empties the buffer.
+ */
+int sb_buffer_flush(SB_Buffer *b){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (b->sink == NULL || b->len == 0) return 1;
+    if (!b->sink->write_fn(b->sink->ctx, b->str, b->len)) return 0;
+    
+    return sb_buffer_clear(b);
+}
+
+/* --- Editing --- */
+
+/**
+ * @brief Drops the first n bytes, advancing the head offset of a heap block.
+ */
+int sb_buffer_consume(SB_Buffer *b, size_t n){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (n >= b->len) return sb_buffer_clear(b);
+    
+    if (b->str == b->init || n > UINT32_MAX - b->head) {
+        /* At most inline_cap bytes (cheaper than tracking a head), or a head
+           that would no longer fit its 32 bits */
+        memmove(b->str, b->str + n, b->len - n + SB_BUFFER_TAIL(b));
+    } else {
+        b->str += n;
+        b->cap -= n;
+        b->head += (uint32_t)n;
+    }
+    
+    b->len -= n;
+    b->hash = 0;
+    return 1;
+}
+
+/**
+ * @brief Inserts len bytes at offset pos, moving the shorter side.
+ */
+int sb_buffer_insert(SB_Buffer *b, size_t pos, const char *s, size_t len){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (pos > b->len || (s == NULL && len)) return 0;
+    if (len == 0) return 1;
+    
+    if (b->head >= len && pos < b->len - pos) {
+        /* Room in front and fewer bytes before pos: slide them down into the head */
+        b->str -= len;
+        b->cap += len;
+        b->head -= (uint32_t)len;
+        memmove(b->str, b->str + len, pos);
+    } else {
+        /* Sink-backed buffers grow here too: flushing would lose pos */
+        if (len > SB_BUFFER_ROOM(b) && !sb_buffer_grow_block(b, len)) return 0;
+        memmove(b->str + pos + len, b->str + pos, b->len - pos + SB_BUFFER_TAIL(b));
+    }
+    
+    memcpy(b->str + pos, s, len);
     b->len += len;
-    b->str[b->len] = '\0'; 
+    b->hash = 0;
+    return 1;
+}
+
+/**
+ * @brief Inserts len bytes at the front.
+ */
+int sb_buffer_prepend(SB_Buffer *b, const char *s, size_t len){
+    return sb_buffer_insert(b, 0, s, len);
+}
+
+/**
+ * @brief Removes n bytes at offset pos, moving the shorter side.
+ */
+int sb_buffer_erase(SB_Buffer *b, size_t pos, size_t n){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (pos > b->len) return 0;
+    if (n > b->len - pos) n = b->len - pos;
+    if (n == 0) return 1;
+    if (pos == 0) return sb_buffer_consume(b, n);
+    
+    if (b->str != b->init && pos < b->len - pos - n && n <= UINT32_MAX - b->head) {
+        /* Fewer bytes before the hole: slide them up, the gap joins the head */
+        memmove(b->str + n, b->str, pos);
+        b->str += n;
+        b->cap -= n;
+        b->head += (uint32_t)n;
+    } else {
+        memmove(b->str + pos, b->str + pos + n, b->len - pos - n + SB_BUFFER_TAIL(b));
+    }
+    
+    b->len -= n;
+    b->hash = 0;
+    return 1;
+}
+
+/**
+ * @brief Moves the content back to the start of its storage.
+ */
+int sb_buffer_compact(SB_Buffer *b){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    
+    if (b->head) sb_buffer_rewind(b);
     return 1;
 }
 
@@ -88,9 +809,20 @@ int sb_buffer_add_lstring(SB_Buffer *b, const char *s, size_t len){
 const char *sb_buffer_get_str(SB_Buffer *b){
     /* Returns NULL if pointer is invalid */
     CHECK_SB_BUFFER_POINTER_RET(b, NULL); 
+    
+    /* Binary mode: terminate on demand */
+    if ((b->flags & SB_BUFFER_BINARY) && !sb_buffer_terminate(b)) return NULL;
     return b->str;	
 }
 
+/**
+ * @brief Returns the content, terminated or not.
+ */
+const char *sb_buffer_data(SB_Buffer *b){
+    CHECK_SB_BUFFER_POINTER_RET(b, NULL);
+    return b->str;
+}
+
 /*get the length of the string*/
 size_t sb_buffer_get_len(SB_Buffer *b){
     /* Returns 0 (zero) if pointer is invalid */
@@ -105,15 +837,18 @@ int sb_buffer_finalize(SB_Buffer *b){
     /* Returns without action if pointer is invalid */
     CHECK_SB_BUFFER_POINTER_RET(b, 0); 
     
+    SB_STATS_RELEASE(1, b->str != b->init, b->len);
     if ( b->str != b->init){
-        free(b->str);
+        b->alloc->free_fn(b->alloc->ctx, b->str - b->head, b->cap + b->head);
     }
     
     /* For security: reset the structure state */
     b->str = b->init;
     b->str[0] = '\0';
     b->len = 0;
-    b->cap = SB_BUFFER_INITIAL_CAP;
+    b->cap = SB_BUFFER_INLINE_LIMIT(b);
+    b->head = 0;
+    b->hash = 0;
     
     return 1;
 }
@@ -125,14 +860,18 @@ int sb_buffer_reset(SB_Buffer *b) {
     /* Returns without action if pointer is invalid */
     CHECK_SB_BUFFER_POINTER_RET(b, 0);
     
+    SB_STATS_RELEASE(0, b->str != b->init, b->len);
+    
     /* Free memory ONLY if b->str is NOT pointing to b->init */
     if (b->str != b->init) { 
-        free(b->str);
+        b->alloc->free_fn(b->alloc->ctx, b->str - b->head, b->cap + b->head);
     }
     
     /* Reset to initial stack state */
     b->len = 0;
-    b->cap = SB_BUFFER_INITIAL_CAP;
+    b->cap = SB_BUFFER_INLINE_LIMIT(b);
+    b->head = 0;
+    b->hash = 0;
     b->str = b->init;
     b->str[0] = '\0';
     
@@ -146,13 +885,24 @@ int sb_buffer_clear(SB_Buffer *b) {
     /* Returns without action if pointer is invalid */
     CHECK_SB_BUFFER_POINTER_RET(b, 0);
     
-    /* Only reset length and null terminator */
+    /* Only reset length, consumed head and null terminator */
+    b->str -= b->head;
+    b->cap += b->head;
+    b->head = 0;
     b->len = 0;
     b->str[0] = '\0';
+    b->hash = 0;
     
     return 1;
 }
 
+/**
+ * @brief Reports an invalid buffer pointer (cold path of the check macro).
+ */
+void sb_buffer_report_invalid(const char *file, int line){
+    fprintf(stderr, "SB_Buffer Error: Invalid or uninitialized buffer pointer. File: %s, Line: %d\n", file, line);
+}
+
 /**
  * @brief Checks if the given pointer is a valid, initialized Buffer structure.
  */
@@ -165,14 +915,58 @@ int sb_buffer_isbuffer(SB_Buffer *b){
 }
 
 
-/* copy src to dest */
+/* copy src to dest, reusing the capacity dest already has */
 int sb_buffer_copy(SB_Buffer *src, SB_Buffer *dest) {
 	
     CHECK_SB_BUFFER_POINTER_RET(src, 0); 
     
     if (!sb_buffer_isbuffer(dest)) return 0;
+    if (src == dest) return 1;
+    SB_STATS_COPY(src->len);
 
-    sb_buffer_reset(dest); 
+    /* Drop the old content before growing, so realloc has nothing to copy */
+    sb_buffer_clear(dest);
+    
+    return sb_buffer_add_lstring_fast(dest, src->str, src->len);
+}
+
+/* move src to dest: steals the heap block in O(1), copies only SSO content */
+int sb_buffer_move(SB_Buffer *src, SB_Buffer *dest) {
+    
+    CHECK_SB_BUFFER_POINTER_RET(src, 0); 
     
-    return sb_buffer_add_lstring(dest, src->str, src->len);
+    if (!sb_buffer_isbuffer(dest)) return 0;
+    if (src == dest) return 1;
+    
+    /* The mode travels with the content: binary content may have no room for a terminator */
+    dest->flags = (dest->flags & ~(uint32_t)SB_BUFFER_BINARY) | (src->flags & SB_BUFFER_BINARY);
+    if (dest->sink && dest->str == dest->init) dest->cap = SB_BUFFER_INLINE_LIMIT(dest);
+    
+    if (src->str == src->init) {
+        /* Inline content cannot be handed over: copy it and empty src */
+        if (!sb_buffer_copy(src, dest)) return 0;
+        return sb_buffer_clear(src);
+    }
+    
+    /* Release the old heap block of dest, then take ownership of src's */
+    if (dest->str != dest->init) {
+        dest->alloc->free_fn(dest->alloc->ctx, dest->str - dest->head, dest->cap + dest->head);
+    }
+    
+    dest->str = src->str;
+    dest->len = src->len;
+    dest->cap = src->cap;
+    dest->head = src->head;
+    dest->hash = src->hash;
+    dest->alloc = src->alloc;
+    
+    /* src goes back to its empty stack state */
+    src->str = src->init;
+    src->len = 0;
+    src->cap = SB_BUFFER_INLINE_LIMIT(src);
+    src->head = 0;
+    src->hash = 0;
+    src->str[0] = '\0';
+    
+    return 1;
 }
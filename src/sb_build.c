@@ -0,0 +1,155 @@
+#define _POSIX_C_SOURCE 200809L /* pthread, sysconf */
+#include "sb_build.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* State shared by the threads of one build */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    unsigned filled;  /* Spawned workers done formatting */
+    int phase;        /* 0 while formatting, then 1 to copy the pieces or -1 to drop them */
+    char *out;        /* Where the pieces go: dest->str + dest->len once reserved */
+    SB_BuildFn fn;
+    void *ctx;
+} SB_BuildShared;
+
+/* One slice of the record range and the piece it was formatted into */
+typedef struct {
+    SB_BuildShared *shared;
+    SB_Buffer piece;
+    size_t begin, end;
+    size_t offset;    /* Position of the piece in the output */
+    int ok;
+    int spawned;
+    pthread_t tid;
+} SB_BuildWorker;
+
+static void *sb_build_thread(void *arg){
+    SB_BuildWorker *w = (SB_BuildWorker*)arg;
+    SB_BuildShared *s = w->shared;
+    int phase;
+
+    w->ok = s->fn(s->ctx, &w->piece, w->begin, w->end);
+
+    /* Report, then wait for the destination to be sized */
+    pthread_mutex_lock(&s->lock);
+    s->filled++;
+    pthread_cond_broadcast(&s->cond);
+    while ((phase = s->phase) == 0) pthread_cond_wait(&s->cond, &s->lock);
+    pthread_mutex_unlock(&s->lock);
+
+    if (phase > 0) memcpy(s->out + w->offset, w->piece.str, w->piece.len);
+    return NULL;
+}
+
+/**
+ * @brief Appends the records [0, count) to dest, formatting them on several threads.
+ */
+int sb_buffer_build_parallel(SB_Buffer *dest, size_t count, unsigned threads, SB_BuildFn fn, void *ctx){
+    SB_BuildShared s;
+    SB_BuildWorker *workers;
+    size_t total = 0, slice, extra, old_len;
+    unsigned i, spawned = 0;
+    int ok = 1;
+
+    CHECK_SB_BUFFER_POINTER_RET(dest, 0);
+    if (fn == NULL) return 0;
+    if (count == 0) return 1;
+
+    if (threads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? (unsigned)(n < SB_BUILD_MAX_THREADS ? n : SB_BUILD_MAX_THREADS) : 1;
+    }
+    if (threads > SB_BUILD_MAX_THREADS) threads = SB_BUILD_MAX_THREADS;
+    if (threads > count) threads = (unsigned)count;
+
+    workers = (SB_BuildWorker*)calloc(threads, sizeof(SB_BuildWorker));
+    if (!workers) return 0;
+
+    pthread_mutex_init(&s.lock, NULL);
+    pthread_cond_init(&s.cond, NULL);
+    s.filled = 0;
+    s.phase = 0;
+    s.out = NULL;
+    s.fn = fn;
+    s.ctx = ctx;
+
+    /* Even slices; the first count % threads get one more record */
+    slice = count / threads;
+    extra = count % threads;
+    for (i = 0; i < threads; i++) {
+        SB_BuildWorker *w = &workers[i];
+        w->shared = &s;
+        w->begin = slice * i + (i < extra ? i : extra);
+        w->end = w->begin + slice + (i < extra);
+        sb_buffer_init(&w->piece);
+        /* Used from several threads at once: the default allocator need not be thread-safe */
+        sb_buffer_set_allocator(&w->piece, &sb_buffer_malloc_allocator);
+    }
+
+    for (i = 1; i < threads; i++) {
+        workers[i].spawned = pthread_create(&workers[i].tid, NULL, sb_build_thread, &workers[i]) == 0;
+        spawned += (unsigned)workers[i].spawned;
+    }
+
+    /* The caller formats the first slice straight into dest (its piece stays
+       empty), then the slices no thread could be started for */
+    old_len = dest->len;
+    workers[0].ok = fn(ctx, dest, workers[0].begin, workers[0].end);
+    for (i = 1; i < threads; i++) {
+        if (!workers[i].spawned) workers[i].ok = fn(ctx, &workers[i].piece, workers[i].begin, workers[i].end);
+    }
+
+    pthread_mutex_lock(&s.lock);
+    while (s.filled < spawned) pthread_cond_wait(&s.cond, &s.lock);
+
+    /* Prefix sum over the piece lengths */
+    for (i = 0; i < threads; i++) {
+        ok &= workers[i].ok;
+        if (workers[i].piece.len > (size_t)-1 / 2 - total) ok = 0;
+        workers[i].offset = total;
+        total += workers[i].piece.len;
+    }
+
+    /* Size the destination once; a sink-backed one is fed in order below */
+    if (ok && dest->sink == NULL) {
+        if (total <= (size_t)-1 / 2 - dest->len && sb_buffer_reserve(dest, dest->len + total)) {
+            s.out = dest->str + dest->len;
+            s.phase = 1;
+        } else {
+            ok = 0;
+        }
+    }
+    if (s.phase == 0) s.phase = -1;
+    pthread_cond_broadcast(&s.cond);
+    pthread_mutex_unlock(&s.lock);
+
+    for (i = 0; i < threads; i++) {
+        if (!workers[i].spawned && s.phase > 0) memcpy(s.out + workers[i].offset, workers[i].piece.str, workers[i].piece.len);
+    }
+    for (i = 0; i < threads; i++) {
+        if (workers[i].spawned) pthread_join(workers[i].tid, NULL);
+    }
+
+    if (s.phase > 0) {
+        dest->len += total;
+        SB_BUFFER_TERMINATE(dest);
+        dest->hash = 0;
+    } else if (ok) {
+        for (i = 1; i < threads && ok; i++) ok = sb_buffer_add_lstring(dest, workers[i].piece.str, workers[i].piece.len);
+    } else if (dest->sink == NULL) {
+        /* Drop what the first slice appended */
+        dest->len = old_len;
+        SB_BUFFER_TERMINATE(dest);
+        dest->hash = 0;
+    }
+
+    for (i = 0; i < threads; i++) sb_buffer_finalize(&workers[i].piece);
+    pthread_cond_destroy(&s.cond);
+    pthread_mutex_destroy(&s.lock);
+    free(workers);
+    return ok;
+}
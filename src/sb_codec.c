@@ -0,0 +1,315 @@
+#include "sb_codec.h"
+#include "sb_simd.h"
+#include <string.h>
+
+static const char sb_hex_digits[] = "0123456789abcdef";
+
+static const char sb_b64_std[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char sb_b64_url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/* Hex digit values (both cases); 0xFF marks invalid characters */
+static const unsigned char sb_hex_values[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+/* Base64 sextet values ('+'/'-' = 62, '/'/'_' = 63); 0xFF marks invalid characters */
+static const unsigned char sb_b64_values[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0x3E, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+/* --- Hex kernels --- */
+
+/* Encodes n bytes into 2n characters; returns the number of input bytes done */
+static size_t sb_hex_encode_simd(char *out, const unsigned char *in, size_t n){
+    size_t i = 0;
+#if defined(SB_SIMD_SSE2)
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i gap = _mm_set1_epi8('a' - '0' - 10);
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+        __m128i lo = _mm_and_si128(x, mask);
+        /* digit = v + '0' (+ gap for a..f) */
+        hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), gap));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), gap));
+        _mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#elif defined(SB_SIMD_NEON)
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    const uint8x16_t nine = vdupq_n_u8(9);
+    const uint8x16_t zero = vdupq_n_u8('0');
+    const uint8x16_t gap = vdupq_n_u8('a' - '0' - 10);
+
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t x = vld1q_u8(in + i);
+        uint8x16x2_t d;
+        uint8x16_t hi = vshrq_n_u8(x, 4);
+        uint8x16_t lo = vandq_u8(x, mask);
+        d.val[0] = vaddq_u8(vaddq_u8(hi, zero), vandq_u8(vcgtq_u8(hi, nine), gap));
+        d.val[1] = vaddq_u8(vaddq_u8(lo, zero), vandq_u8(vcgtq_u8(lo, nine), gap));
+        vst2q_u8((uint8_t*)out + 2 * i, d); /* interleaves hi/lo */
+    }
+#else
+    (void)out; (void)in; (void)n;
+#endif
+    return i;
+}
+
+/* Decodes 2n characters into n bytes; returns the number of output bytes
+   done (stops early at the first block holding an invalid character) */
+static size_t sb_hex_decode_simd(unsigned char *out, const char *in, size_t n){
+    size_t i = 0;
+#if defined(SB_SIMD_SSE2)
+    const __m128i c0 = _mm_set1_epi8('0');
+    const __m128i ca = _mm_set1_epi8('a');
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i five = _mm_set1_epi8(5);
+    const __m128i ten = _mm_set1_epi8(10);
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    __m128i v[2];
+    int k;
+
+    for (; i + 16 <= n; i += 16) {
+        for (k = 0; k < 2; k++) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(in + 2 * i + 16 * k));
+            __m128i d = _mm_sub_epi8(x, c0);
+            __m128i l = _mm_sub_epi8(_mm_or_si128(x, lower), ca);
+            /* unsigned v <= m  <=>  max(v, m) == m */
+            __m128i is_d = _mm_cmpeq_epi8(_mm_max_epu8(d, nine), nine);
+            __m128i is_l = _mm_cmpeq_epi8(_mm_max_epu8(l, five), five);
+            if (_mm_movemask_epi8(_mm_or_si128(is_d, is_l)) != 0xFFFF) return i;
+            v[k] = _mm_or_si128(_mm_and_si128(is_d, d), _mm_and_si128(is_l, _mm_add_epi8(l, ten)));
+            /* Each 16-bit lane holds (high nibble, low nibble): merge into one byte */
+            v[k] = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v[k], low_byte), 4), _mm_srli_epi16(v[k], 8));
+        }
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(v[0], v[1]));
+    }
+#else
+    (void)out; (void)in; (void)n;
+#endif
+    return i;
+}
+
+/* --- Hex --- */
+
+int sb_buffer_add_hex(SB_Buffer *b, const void *data, size_t len){
+    const unsigned char *in = (const unsigned char*)data;
+    char *out;
+    size_t i;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if ((data == NULL && len) || len > (size_t)-1 / 4) return 0;
+
+    out = sb_buffer_prepare(b, 2 * len);
+    if (!out) return 0;
+
+    i = sb_hex_encode_simd(out, in, len);
+    for (; i < len; i++) {
+        out[2 * i] = sb_hex_digits[in[i] >> 4];
+        out[2 * i + 1] = sb_hex_digits[in[i] & 0xF];
+    }
+
+    return sb_buffer_commit(b, 2 * len);
+}
+
+int sb_buffer_add_hex_decoded(SB_Buffer *b, const char *s, size_t len){
+    unsigned char *out;
+    size_t i, n = len / 2;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if ((s == NULL && len) || (len & 1)) return 0;
+
+    out = (unsigned char*)sb_buffer_prepare(b, n);
+    if (!out) return 0;
+
+    i = sb_hex_decode_simd(out, s, n);
+    for (; i < n; i++) {
+        unsigned hi = sb_hex_values[(unsigned char)s[2 * i]];
+        unsigned lo = sb_hex_values[(unsigned char)s[2 * i + 1]];
+        if ((hi | lo) & 0xF0) {
+            /* Invalid text: leave the content unchanged */
+            SB_BUFFER_TERMINATE(b);
+            return 0;
+        }
+        out[i] = (unsigned char)(hi << 4 | lo);
+    }
+
+    return sb_buffer_commit(b, n);
+}
+
+/* --- Base64 kernels --- */
+
+#if defined(SB_SIMD_AVX2)
+/* 12 input bytes -> 16 characters per step (W. Mula's pshufb method);
+   returns the number of input bytes done */
+SB_TARGET_SSSE3 static size_t sb_b64_encode_ssse3(char *out, const unsigned char *in, size_t n, int url){
+    const __m128i shuf = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    /* Offset added to each sextet class: A-Z, a-z, 0-9, then '+'/'-' and '/'/'_' */
+    const __m128i lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                      (char)((url ? '-' : '+') - 62), (char)((url ? '_' : '/') - 63),
+                                      'A', 0, 0);
+    size_t i = 0, o = 0;
+
+    /* Loads read 16 bytes: keep 4 bytes of slack at the end */
+    for (; i + 16 <= n; i += 12, o += 16) {
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i)), shuf);
+        __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(x, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        __m128i t1 = _mm_mullo_epi16(_mm_and_si128(x, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        __m128i idx = _mm_or_si128(t0, t1);
+        __m128i cls = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+        cls = _mm_or_si128(cls, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx), _mm_set1_epi8(13)));
+        _mm_storeu_si128((__m128i*)(out + o), _mm_add_epi8(idx, _mm_shuffle_epi8(lut, cls)));
+    }
+    return i;
+}
+#endif
+
+/* Encodes whole 3-byte groups from offset i on; returns the input offset reached */
+static size_t sb_b64_encode_groups(char *out, const unsigned char *in, size_t n, size_t i, const char *alphabet){
+    char *o = out + i / 3 * 4;
+
+    for (; i + 3 <= n; i += 3) {
+        unsigned v = (unsigned)in[i] << 16 | (unsigned)in[i + 1] << 8 | in[i + 2];
+        o[0] = alphabet[v >> 18];
+        o[1] = alphabet[(v >> 12) & 0x3F];
+        o[2] = alphabet[(v >> 6) & 0x3F];
+        o[3] = alphabet[v & 0x3F];
+        o += 4;
+    }
+    return i;
+}
+
+/* Encoded length of len bytes */
+static size_t sb_b64_encoded_len(size_t len, int pad){
+    return pad ? (len + 2) / 3 * 4 : len / 3 * 4 + (len % 3 ? len % 3 + 1 : 0);
+}
+
+static int sb_b64_encode(SB_Buffer *b, const void *data, size_t len, int url){
+    const unsigned char *in = (const unsigned char*)data;
+    const char *alphabet = url ? sb_b64_url : sb_b64_std;
+    size_t out_len, i = 0;
+    char *out, *o;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if ((data == NULL && len) || len > (size_t)-1 / 2) return 0;
+
+    out_len = sb_b64_encoded_len(len, !url);
+    out = sb_buffer_prepare(b, out_len);
+    if (!out) return 0;
+
+#if defined(SB_SIMD_AVX2)
+    if (sb_simd_has_ssse3()) i = sb_b64_encode_ssse3(out, in, len, url);
+#endif
+    i = sb_b64_encode_groups(out, in, len, i, alphabet);
+
+    /* Last 1 or 2 bytes */
+    o = out + i / 3 * 4;
+    if (len - i == 1) {
+        o[0] = alphabet[in[i] >> 2];
+        o[1] = alphabet[(in[i] & 0x03) << 4];
+        if (!url) { o[2] = '='; o[3] = '='; }
+    } else if (len - i == 2) {
+        o[0] = alphabet[in[i] >> 2];
+        o[1] = alphabet[(in[i] & 0x03) << 4 | in[i + 1] >> 4];
+        o[2] = alphabet[(in[i + 1] & 0x0F) << 2];
+        if (!url) o[3] = '=';
+    }
+
+    return sb_buffer_commit(b, out_len);
+}
+
+int sb_buffer_add_base64(SB_Buffer *b, const void *data, size_t len){
+    return sb_b64_encode(b, data, len, 0);
+}
+
+int sb_buffer_add_base64url(SB_Buffer *b, const void *data, size_t len){
+    return sb_b64_encode(b, data, len, 1);
+}
+
+int sb_buffer_add_base64_decoded(SB_Buffer *b, const char *s, size_t len){
+    const unsigned char *in = (const unsigned char*)s;
+    unsigned char *out, *o;
+    size_t i, full, rest, out_len;
+    unsigned bad = 0;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (s == NULL && len) return 0;
+
+    /* Strip the padding, then a lone trailing character is impossible */
+    if (len % 4 == 0 && len >= 2) {
+        if (s[len - 1] == '=') len--;
+        if (s[len - 1] == '=') len--;
+    }
+    full = len / 4;
+    rest = len % 4;
+    if (rest == 1) return 0;
+
+    out_len = full * 3 + (rest ? rest - 1 : 0);
+    o = out = (unsigned char*)sb_buffer_prepare(b, out_len);
+    if (!out) return 0;
+
+    /* Table driven: invalid characters set 0xFF bits that poison "bad" */
+    for (i = 0; i < full * 4; i += 4) {
+        unsigned a = sb_b64_values[in[i]], c = sb_b64_values[in[i + 1]];
+        unsigned d = sb_b64_values[in[i + 2]], e = sb_b64_values[in[i + 3]];
+        unsigned v = a << 18 | c << 12 | d << 6 | e;
+        bad |= a | c | d | e;
+        o[0] = (unsigned char)(v >> 16);
+        o[1] = (unsigned char)(v >> 8);
+        o[2] = (unsigned char)v;
+        o += 3;
+    }
+
+    if (rest) {
+        unsigned a = sb_b64_values[in[i]], c = sb_b64_values[in[i + 1]];
+        unsigned d = rest == 3 ? sb_b64_values[in[i + 2]] : 0;
+        unsigned v = a << 18 | c << 12 | d << 6;
+        bad |= a | c | d;
+        o[0] = (unsigned char)(v >> 16);
+        if (rest == 3) o[1] = (unsigned char)(v >> 8);
+    }
+
+    if (bad & 0xC0) {
+        /* Invalid text: leave the content unchanged */
+        SB_BUFFER_TERMINATE(b);
+        return 0;
+    }
+
+    return sb_buffer_commit(b, out_len);
+}
@@ -0,0 +1,242 @@
+#include "sb_compare.h"
+#include "sb_simd.h"
+#include <string.h>
+
+/* Beyond this length equality goes to the (vectorized) libc memcmp */
+#define SB_COMPARE_SMALL 16
+
+/* --- Word helpers --- */
+
+static inline uint64_t sb_cmp_r8(const char *p){ uint64_t v; memcpy(&v, p, 8); return v; }
+static inline uint64_t sb_cmp_r4(const char *p){ uint32_t v; memcpy(&v, p, 4); return v; }
+
+/* 1 to 3 bytes: first, middle and last (enough to compare two keys of the same length) */
+static inline uint64_t sb_cmp_r3(const char *p, size_t n){
+    return (uint64_t)(unsigned char)p[0] | ((uint64_t)(unsigned char)p[n >> 1] << 8) |
+           ((uint64_t)(unsigned char)p[n - 1] << 16);
+}
+
+#define SB_CMP_ONES 0x0101010101010101ull
+#define SB_CMP_HIGH 0x8080808080808080ull
+
+/* Lowercases the ASCII letters of 8 packed bytes (SWAR) */
+static inline uint64_t sb_cmp_fold(uint64_t w){
+    uint64_t low7 = w & ~SB_CMP_HIGH;
+    uint64_t ge_a = low7 + (0x80 - 'A') * SB_CMP_ONES;     /* High bit: byte >= 'A' */
+    uint64_t gt_z = low7 + (0x80 - 'Z' - 1) * SB_CMP_ONES; /* High bit: byte > 'Z' */
+    uint64_t upper = ge_a & ~gt_z & ~w & SB_CMP_HIGH;      /* ASCII uppercase only */
+    return w | (upper >> 2);
+}
+
+static inline unsigned char sb_cmp_lower(unsigned char c){
+    return (unsigned char)(c + (((unsigned)c - 'A' < 26u) << 5));
+}
+
+/* n <= 16 with overlapping loads; fold selects the case-insensitive form */
+static inline int sb_cmp_small(const char *p, const char *q, size_t n, int fold){
+    uint64_t a0, b0, a1, b1;
+
+    if (n >= 8) {
+        a0 = sb_cmp_r8(p); b0 = sb_cmp_r8(q);
+        a1 = sb_cmp_r8(p + n - 8); b1 = sb_cmp_r8(q + n - 8);
+    } else if (n >= 4) {
+        a0 = sb_cmp_r4(p); b0 = sb_cmp_r4(q);
+        a1 = sb_cmp_r4(p + n - 4); b1 = sb_cmp_r4(q + n - 4);
+    } else if (n > 0) {
+        a0 = sb_cmp_r3(p, n); b0 = sb_cmp_r3(q, n);
+        a1 = b1 = 0;
+    } else {
+        return 1;
+    }
+
+    if (fold) {
+        a0 = sb_cmp_fold(a0); b0 = sb_cmp_fold(b0);
+        a1 = sb_cmp_fold(a1); b1 = sb_cmp_fold(b1);
+    }
+    return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+}
+
+/* --- Case-insensitive kernels for n > 16 --- */
+
+#if defined(SB_SIMD_SSE2)
+
+static inline __m128i sb_sse2_fold(__m128i x){
+    /* 'A'..'Z' map to -128..-103 after the shift, everything else compares above */
+    __m128i shifted = _mm_sub_epi8(x, _mm_set1_epi8((char)('A' + 128)));
+    __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+    return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+static int sb_icase_long(const char *p, const char *q, size_t n){
+    size_t i = 0;
+
+    for (;;) {
+        __m128i a = sb_sse2_fold(_mm_loadu_si128((const __m128i*)(p + i)));
+        __m128i b = sb_sse2_fold(_mm_loadu_si128((const __m128i*)(q + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF) return 0;
+        if (i + 16 == n) return 1;
+        /* Last vector overlaps the previous one */
+        i = i + 32 <= n ? i + 16 : n - 16;
+    }
+}
+
+#elif defined(SB_SIMD_NEON)
+
+static inline uint8x16_t sb_neon_fold(uint8x16_t x){
+    uint8x16_t upper = vcltq_u8(vsubq_u8(x, vdupq_n_u8('A')), vdupq_n_u8(26));
+    return vorrq_u8(x, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+static int sb_icase_long(const char *p, const char *q, size_t n){
+    size_t i = 0;
+
+    for (;;) {
+        uint8x16_t a = sb_neon_fold(vld1q_u8((const uint8_t*)(p + i)));
+        uint8x16_t b = sb_neon_fold(vld1q_u8((const uint8_t*)(q + i)));
+        if (vminvq_u8(vceqq_u8(a, b)) != 0xFF) return 0;
+        if (i + 16 == n) return 1;
+        i = i + 32 <= n ? i + 16 : n - 16;
+    }
+}
+
+#else
+
+static int sb_icase_long(const char *p, const char *q, size_t n){
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        if (sb_cmp_fold(sb_cmp_r8(p + i)) != sb_cmp_fold(sb_cmp_r8(q + i))) return 0;
+    }
+    return i == n || sb_cmp_fold(sb_cmp_r8(p + n - 8)) == sb_cmp_fold(sb_cmp_r8(q + n - 8));
+}
+
+#endif
+
+/* --- Raw memory kernels --- */
+
+/**
+ * @brief Tests n bytes for equality.
+ */
+int sb_mem_equal(const char *p, const char *q, size_t n){
+    if (n <= SB_COMPARE_SMALL) return sb_cmp_small(p, q, n, 0);
+    return memcmp(p, q, n) == 0;
+}
+
+/**
+ * @brief Tests n bytes for equality, ignoring ASCII case.
+ */
+int sb_mem_equal_icase(const char *p, const char *q, size_t n){
+    if (n <= SB_COMPARE_SMALL) return sb_cmp_small(p, q, n, 1);
+    return sb_icase_long(p, q, n);
+}
+
+/* Ordering of the folded bytes: skips equal words, then finds the first difference */
+static int sb_mem_compare_icase(const char *p, const char *q, size_t n){
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        if (sb_cmp_fold(sb_cmp_r8(p + i)) != sb_cmp_fold(sb_cmp_r8(q + i))) break;
+    }
+    for (; i < n; i++) {
+        int d = (int)sb_cmp_lower((unsigned char)p[i]) - (int)sb_cmp_lower((unsigned char)q[i]);
+        if (d) return d;
+    }
+    return 0;
+}
+
+/* --- Buffer API --- */
+
+/**
+ * @brief Tests two buffers for equal content.
+ */
+int sb_buffer_equals(SB_Buffer *a, SB_Buffer *b){
+    CHECK_SB_BUFFER_POINTER_RET(a, 0);
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (a->len != b->len) return 0;
+    /* Both hashes cached and different: the contents differ */
+    if (a->hash && b->hash && a->hash != b->hash) return 0;
+    return sb_mem_equal(a->str, b->str, a->len);
+}
+
+/**
+ * @brief Tests the buffer content against s[0..len).
+ */
+int sb_buffer_equals_lstring(SB_Buffer *b, const char *s, size_t len){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (b->len != len || (s == NULL && len)) return 0;
+    return sb_mem_equal(b->str, s, len);
+}
+
+/**
+ * @brief Tests the buffer content against s[0..len), ignoring ASCII case.
+ */
+int sb_buffer_equals_icase(SB_Buffer *b, const char *s, size_t len){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (b->len != len || (s == NULL && len)) return 0;
+    return sb_mem_equal_icase(b->str, s, len);
+}
+
+/**
+ * @brief Orders two buffers like memcmp, a shorter prefix first.
+ */
+int sb_buffer_compare(SB_Buffer *a, SB_Buffer *b){
+    size_t n;
+    int d;
+
+    CHECK_SB_BUFFER_POINTER_RET(a, 0);
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    n = a->len < b->len ? a->len : b->len;
+    d = n ? memcmp(a->str, b->str, n) : 0;
+    if (d) return d;
+    return (a->len > b->len) - (a->len < b->len);
+}
+
+/**
+ * @brief Orders two buffers ignoring ASCII case.
+ */
+int sb_buffer_compare_icase(SB_Buffer *a, SB_Buffer *b){
+    size_t n;
+    int d;
+
+    CHECK_SB_BUFFER_POINTER_RET(a, 0);
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    n = a->len < b->len ? a->len : b->len;
+    d = sb_mem_compare_icase(a->str, b->str, n);
+    if (d) return d;
+    return (a->len > b->len) - (a->len < b->len);
+}
+
+/**
+ * @brief Tests whether the content starts with s[0..len).
+ */
+int sb_buffer_starts_with(SB_Buffer *b, const char *s, size_t len){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (len > b->len || (s == NULL && len)) return 0;
+    return sb_mem_equal(b->str, s, len);
+}
+
+/**
+ * @brief Tests whether the content starts with s[0..len), ignoring ASCII case.
+ */
+int sb_buffer_starts_with_icase(SB_Buffer *b, const char *s, size_t len){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (len > b->len || (s == NULL && len)) return 0;
+    return sb_mem_equal_icase(b->str, s, len);
+}
+
+/**
+ * @brief Tests whether the content ends with s[0..len).
+ */
+int sb_buffer_ends_with(SB_Buffer *b, const char *s, size_t len){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (len > b->len || (s == NULL && len)) return 0;
+    return sb_mem_equal(b->str + b->len - len, s, len);
+}
@@ -0,0 +1,252 @@
+#include "sb_escape.h"
+#include "sb_search.h"
+#include "sb_simd.h"
+#include <string.h>
+
+/* --- JSON scanner: first byte that is '"', '\\' or a control byte --- */
+
+#define SB_JSON_NEEDS_ESCAPE(c) ((unsigned char)(c) < 0x20 || (c) == '"' || (c) == '\\')
+
+static size_t sb_json_scan_scalar(const char *p, size_t n){
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (SB_JSON_NEEDS_ESCAPE(p[i])) return i;
+    }
+    return n;
+}
+
+#if defined(SB_SIMD_SSE2)
+static size_t sb_json_scan_sse2(const char *p, size_t n){
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(p + i));
+        /* x <= 0x1F (unsigned) <=> max(x, 0x1F) == 0x1F */
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, bslash)),
+                                   _mm_cmpeq_epi8(_mm_max_epu8(x, ctrl), ctrl));
+        unsigned m = (unsigned)_mm_movemask_epi8(hit);
+        if (m) return i + SB_CTZ(m);
+    }
+    return i + sb_json_scan_scalar(p + i, n - i);
+}
+#endif
+
+#if defined(SB_SIMD_AVX2)
+SB_TARGET_AVX2 static size_t sb_json_scan_avx2(const char *p, size_t n){
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i bslash = _mm256_set1_epi8('\\');
+    const __m256i ctrl = _mm256_set1_epi8(0x1F);
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, bslash)),
+                                      _mm256_cmpeq_epi8(_mm256_max_epu8(x, ctrl), ctrl));
+        unsigned m = (unsigned)_mm256_movemask_epi8(hit);
+        if (m) return i + SB_CTZ(m);
+    }
+    return i + sb_json_scan_scalar(p + i, n - i);
+}
+#endif
+
+#if defined(SB_SIMD_NEON)
+static size_t sb_json_scan_neon(const char *p, size_t n){
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t bslash = vdupq_n_u8('\\');
+    const uint8x16_t space = vdupq_n_u8(0x20);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t x = vld1q_u8((const uint8_t*)p + i);
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(x, quote), vceqq_u8(x, bslash)), vcltq_u8(x, space));
+        uint64_t m = sb_neon_mask(hit);
+        if (m) return i + SB_CTZ(m) / 4;
+    }
+    return i + sb_json_scan_scalar(p + i, n - i);
+}
+#endif
+
+/**
+ * @brief Returns the offset of the first byte needing a JSON escape (n if none).
+ */
+static size_t sb_json_scan(const char *p, size_t n){
+    static size_t (*scan)(const char *, size_t) = NULL;
+
+    if (scan == NULL) {
+#if defined(SB_SIMD_AVX2)
+        scan = sb_simd_has_avx2() ? sb_json_scan_avx2 : sb_json_scan_sse2;
+#elif defined(SB_SIMD_SSE2)
+        scan = sb_json_scan_sse2;
+#elif defined(SB_SIMD_NEON)
+        scan = sb_json_scan_neon;
+#else
+        scan = sb_json_scan_scalar;
+#endif
+    }
+    return scan(p, n);
+}
+
+/* Escape sequence length for a byte that needs one */
+static size_t sb_json_escape_len(char c){
+    switch (c) {
+    case '"': case '\\': case '\b': case '\f': case '\n': case '\r': case '\t':
+        return 2;
+    default:
+        return 6; /* \u00XX */
+    }
+}
+
+/* HTML and CSV special sets (matched with the sb_search kernels) */
+static const char sb_html_specials[] = "&<>\"'";
+static const char sb_csv_specials[] = ",\"\r\n";
+
+/* Offset of the first byte of p[0..n) in set, or n */
+static size_t sb_scan_set(const char *p, size_t n, const char *set){
+    size_t r = sb_search_any(p, n, set);
+    return r == SB_BUFFER_NPOS ? n : r;
+}
+
+/* Exact JSON output size of s[0..len) */
+static size_t sb_json_escaped_len(const char *s, size_t len){
+    size_t need = len, i;
+
+    for (i = sb_json_scan(s, len); i < len; i += 1 + sb_json_scan(s + i + 1, len - i - 1)) {
+        need += sb_json_escape_len(s[i]) - 1;
+    }
+    return need;
+}
+
+/* Exact HTML output size of s[0..len) */
+static size_t sb_html_escaped_len(const char *s, size_t len){
+    size_t need = len, i;
+
+    for (i = sb_scan_set(s, len, sb_html_specials); i < len;
+         i += 1 + sb_scan_set(s + i + 1, len - i - 1, sb_html_specials)) {
+        need += (s[i] == '"' ? 6 : s[i] == '&' || s[i] == '\'' ? 5 : 4) - 1;
+    }
+    return need;
+}
+
+/* The worst case is reserved only when it already fits: no growth, no scan */
+#define SB_ESCAPE_WORST_FITS(b, len, factor) ((len) <= SB_BUFFER_ROOM(b) / (factor))
+
+/* --- JSON --- */
+
+int sb_buffer_add_json_escaped(SB_Buffer *b, const char *s, size_t len){
+    static const char hex[] = "0123456789abcdef";
+    size_t need, i;
+    char *out, *start;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (s == NULL && len) return 0;
+
+    /* Otherwise measure, so that clean text grows the buffer by len only */
+    need = SB_ESCAPE_WORST_FITS(b, len, 6) ? len * 6 : sb_json_escaped_len(s, len);
+
+    start = out = sb_buffer_prepare(b, need);
+    if (!out) return 0;
+
+    i = 0;
+    while (i < len) {
+        size_t run = sb_json_scan(s + i, len - i);
+        char c;
+
+        /* Clean run: one bulk copy */
+        memcpy(out, s + i, run);
+        out += run;
+        i += run;
+        if (i == len) break;
+
+        c = s[i++];
+        *out++ = '\\';
+        switch (c) {
+        case '"': *out++ = '"'; break;
+        case '\\': *out++ = '\\'; break;
+        case '\b': *out++ = 'b'; break;
+        case '\f': *out++ = 'f'; break;
+        case '\n': *out++ = 'n'; break;
+        case '\r': *out++ = 'r'; break;
+        case '\t': *out++ = 't'; break;
+        default:
+            *out++ = 'u'; *out++ = '0'; *out++ = '0';
+            *out++ = hex[((unsigned char)c >> 4) & 0xF];
+            *out++ = hex[(unsigned char)c & 0xF];
+            break;
+        }
+    }
+
+    return sb_buffer_commit(b, (size_t)(out - start));
+}
+
+/* --- HTML --- */
+
+int sb_buffer_add_html_escaped(SB_Buffer *b, const char *s, size_t len){
+    size_t need, i;
+    char *out, *start;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (s == NULL && len) return 0;
+
+    need = SB_ESCAPE_WORST_FITS(b, len, 6) ? len * 6 /* &quot; */ : sb_html_escaped_len(s, len);
+
+    start = out = sb_buffer_prepare(b, need);
+    if (!out) return 0;
+
+    i = 0;
+    while (i < len) {
+        size_t run = sb_scan_set(s + i, len - i, sb_html_specials);
+
+        memcpy(out, s + i, run);
+        out += run;
+        i += run;
+        if (i == len) break;
+
+        switch (s[i++]) {
+        case '&': memcpy(out, "&amp;", 5); out += 5; break;
+        case '<': memcpy(out, "&lt;", 4); out += 4; break;
+        case '>': memcpy(out, "&gt;", 4); out += 4; break;
+        case '"': memcpy(out, "&quot;", 6); out += 6; break;
+        default: memcpy(out, "&#39;", 5); out += 5; break;
+        }
+    }
+
+    return sb_buffer_commit(b, (size_t)(out - start));
+}
+
+/* --- CSV --- */
+
+int sb_buffer_add_csv_quoted(SB_Buffer *b, const char *s, size_t len){
+    size_t need, i;
+    char *out, *start;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (s == NULL && len) return 0;
+
+    /* Clean field: copied as is */
+    if (sb_scan_set(s, len, sb_csv_specials) == len) return sb_buffer_add_lstring_fast(b, s, len);
+
+    need = SB_ESCAPE_WORST_FITS(b, len + 1, 2) ? 2 * len + 2 : len + sb_search_count(s, len, '"') + 2;
+
+    start = out = sb_buffer_prepare(b, need);
+    if (!out) return 0;
+
+    *out++ = '"';
+    i = 0;
+    while (i < len) {
+        size_t r = sb_search_byte(s + i, len - i, '"');
+        size_t run = r == SB_BUFFER_NPOS ? len - i : r + 1;
+
+        /* Copy up to and including the quote, then double it */
+        memcpy(out, s + i, run);
+        out += run;
+        i += run;
+        if (r != SB_BUFFER_NPOS) *out++ = '"';
+    }
+    *out++ = '"';
+
+    return sb_buffer_commit(b, (size_t)(out - start));
+}
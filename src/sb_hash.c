@@ -0,0 +1,274 @@
+#include "sb_hash.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* --- Hash kernel (wyhash-style) --- */
+
+static const uint64_t sb_hash_secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+/* 128-bit product of a and b: low half in *a, high half in *b */
+static inline void sb_hash_mum(uint64_t *a, uint64_t *b){
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t sb_hash_mix(uint64_t a, uint64_t b){
+    sb_hash_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t sb_hash_r8(const uint8_t *p){ uint64_t v; memcpy(&v, p, 8); return v; }
+static inline uint64_t sb_hash_r4(const uint8_t *p){ uint32_t v; memcpy(&v, p, 4); return v; }
+/* 1 to 3 bytes: first, middle and last */
+static inline uint64_t sb_hash_r3(const uint8_t *p, size_t k){
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+/**
+ * @brief Hashes len bytes with the given seed.
+ */
+uint64_t sb_hash_bytes(const void *data, size_t len, uint64_t seed){
+    const uint8_t *p = (const uint8_t*)data;
+    const uint64_t *s = sb_hash_secret;
+    uint64_t a, b;
+
+    seed ^= sb_hash_mix(seed ^ s[0], s[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (sb_hash_r4(p) << 32) | sb_hash_r4(p + ((len >> 3) << 2));
+            b = (sb_hash_r4(p + len - 4) << 32) | sb_hash_r4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = sb_hash_r3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+
+        if (i > 48) {
+            /* Three independent lanes over 48-byte blocks */
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = sb_hash_mix(sb_hash_r8(p) ^ s[1], sb_hash_r8(p + 8) ^ seed);
+                see1 = sb_hash_mix(sb_hash_r8(p + 16) ^ s[2], sb_hash_r8(p + 24) ^ see1);
+                see2 = sb_hash_mix(sb_hash_r8(p + 32) ^ s[3], sb_hash_r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = sb_hash_mix(sb_hash_r8(p) ^ s[1], sb_hash_r8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        /* Last 16 bytes, overlapping what was already mixed */
+        a = sb_hash_r8(p + i - 16);
+        b = sb_hash_r8(p + i - 8);
+    }
+
+    a ^= s[1];
+    b ^= seed;
+    sb_hash_mum(&a, &b);
+    return sb_hash_mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+/* 0 is reserved for "not cached" / "empty slot" */
+static inline uint64_t sb_hash_nonzero(const void *p, size_t len){
+    uint64_t h = sb_hash_bytes(p, len, 0);
+    return h ? h : 1;
+}
+
+/**
+ * @brief Hashes the buffer content, caching the result.
+ */
+uint64_t sb_buffer_hash(SB_Buffer *b){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (b->hash == 0) b->hash = sb_hash_nonzero(b->str, b->len);
+    return b->hash;
+}
+
+/* --- Interning table --- */
+
+#define SB_INTERN_MIN_SLOTS 16
+/* Requests from the arena for the bytes of short strings */
+#define SB_INTERN_CHUNK 16384
+
+/**
+ * @brief Initializes an empty table.
+ */
+int sb_intern_init(SB_InternTable *t, size_t expected){
+    size_t n = SB_INTERN_MIN_SLOTS;
+
+    if (t == NULL || expected >= SB_INTERN_NONE) return 0;
+    while (n / 4 * 3 < expected) n *= 2;
+
+    memset(t, 0, sizeof(*t));
+    t->slots = (SB_InternSlot*)calloc(n, sizeof(SB_InternSlot));
+    if (!t->slots) return 0;
+    t->mask = n - 1;
+    sb_arena_init(&t->arena, 0);
+    return 1;
+}
+
+/* Slot holding (s, len, h), or the empty slot where it belongs */
+static SB_InternSlot *sb_intern_probe(const SB_InternTable *t, const char *s, size_t len, uint64_t h){
+    size_t i = (size_t)h & t->mask;
+
+    for (;;) {
+        SB_InternSlot *slot = &t->slots[i];
+
+        if (slot->hash == 0) return slot;
+        if (slot->hash == h && slot->len == len) {
+            const char *key = len <= SB_INTERN_INLINE ? slot->key : (const char*)t->strings[slot->id].base;
+            if (memcmp(key, s, len) == 0) return slot;
+        }
+        i = (i + 1) & t->mask;
+    }
+}
+
+/* Doubles the slot array, re-placing the slots by their stored hash */
+static int sb_intern_grow(SB_InternTable *t){
+    size_t n = (t->mask + 1) * 2, i;
+    SB_InternSlot *old = t->slots;
+    SB_InternSlot *slots = (SB_InternSlot*)calloc(n, sizeof(SB_InternSlot));
+
+    if (!slots) return 0;
+    for (i = 0; i <= t->mask; i++) {
+        size_t j;
+        if (old[i].hash == 0) continue;
+        for (j = (size_t)old[i].hash & (n - 1); slots[j].hash; j = (j + 1) & (n - 1)) { }
+        slots[j] = old[i];
+    }
+
+    free(old);
+    t->slots = slots;
+    t->mask = n - 1;
+    return 1;
+}
+
+/* Copies the string (and a terminator) into stable storage */
+static const char *sb_intern_store(SB_InternTable *t, const char *s, size_t len){
+    char *p;
+
+    if (len + 1 > t->chunk_left) {
+        /* Long strings get their own block; short ones share chunks */
+        if (len + 1 > SB_INTERN_CHUNK / 4) {
+            p = (char*)sb_arena_alloc(&t->arena, len + 1);
+            if (!p) return NULL;
+            memcpy(p, s, len);
+            p[len] = '\0';
+            return p;
+        }
+        t->chunk = (char*)sb_arena_alloc(&t->arena, SB_INTERN_CHUNK);
+        if (!t->chunk) { t->chunk_left = 0; return NULL; }
+        t->chunk_left = SB_INTERN_CHUNK;
+    }
+
+    p = t->chunk;
+    memcpy(p, s, len);
+    p[len] = '\0';
+    t->chunk += len + 1;
+    t->chunk_left -= len + 1;
+    return p;
+}
+
+static uint32_t sb_intern_hashed(SB_InternTable *t, const char *s, size_t len, uint64_t h){
+    SB_InternSlot *slot;
+    const char *copy;
+
+    slot = sb_intern_probe(t, s, len, h);
+    if (slot->hash) return slot->id;
+
+    /* New string: keep the load factor at 3/4 at most */
+    if (t->count >= SB_INTERN_NONE - 1) return SB_INTERN_NONE;
+    if ((size_t)t->count + 1 > (t->mask + 1) / 4 * 3) {
+        if (!sb_intern_grow(t)) return SB_INTERN_NONE;
+        slot = sb_intern_probe(t, s, len, h);
+    }
+    if (t->count == t->strings_cap) {
+        uint32_t cap = t->strings_cap ? t->strings_cap * 2 : 64;
+        SB_Slice *strings = (SB_Slice*)realloc(t->strings, (size_t)cap * sizeof(SB_Slice));
+        if (!strings) return SB_INTERN_NONE;
+        t->strings = strings;
+        t->strings_cap = cap;
+    }
+
+    copy = sb_intern_store(t, s, len);
+    if (!copy) return SB_INTERN_NONE;
+
+    t->strings[t->count].base = copy;
+    t->strings[t->count].len = len;
+    slot->hash = h;
+    slot->id = t->count;
+    slot->len = (uint32_t)len;
+    memcpy(slot->key, s, len < SB_INTERN_INLINE ? len : SB_INTERN_INLINE);
+    return t->count++;
+}
+
+/**
+ * @brief Returns the ID of a string, adding it if it is new.
+ */
+uint32_t sb_intern(SB_InternTable *t, const char *s, size_t len){
+    if (t == NULL || t->slots == NULL || (s == NULL && len) || len >= SB_INTERN_NONE) return SB_INTERN_NONE;
+    if (s == NULL) s = "";
+    return sb_intern_hashed(t, s, len, sb_hash_nonzero(s, len));
+}
+
+/**
+ * @brief Interns the content of a buffer, reusing its cached hash.
+ */
+uint32_t sb_intern_buffer(SB_InternTable *t, SB_Buffer *b){
+    CHECK_SB_BUFFER_POINTER_RET(b, SB_INTERN_NONE);
+
+    if (t == NULL || t->slots == NULL || b->len >= SB_INTERN_NONE) return SB_INTERN_NONE;
+    return sb_intern_hashed(t, b->str, b->len, sb_buffer_hash(b));
+}
+
+/**
+ * @brief Looks a string up without adding it.
+ */
+uint32_t sb_intern_find(const SB_InternTable *t, const char *s, size_t len){
+    SB_InternSlot *slot;
+
+    if (t == NULL || t->slots == NULL || (s == NULL && len) || len >= SB_INTERN_NONE) return SB_INTERN_NONE;
+    slot = sb_intern_probe(t, s, len, sb_hash_nonzero(s, len));
+    return slot->hash ? slot->id : SB_INTERN_NONE;
+}
+
+/**
+ * @brief Returns the string of an ID.
+ */
+const char *sb_intern_get(const SB_InternTable *t, uint32_t id, size_t *len){
+    if (t == NULL || id >= t->count) return NULL;
+    if (len) *len = t->strings[id].len;
+    return (const char*)t->strings[id].base;
+}
+
+/**
+ * @brief Releases everything the table owns.
+ */
+int sb_intern_finalize(SB_InternTable *t){
+    if (t == NULL) return 0;
+
+    free(t->slots);
+    free(t->strings);
+    sb_arena_finalize(&t->arena);
+    memset(t, 0, sizeof(*t));
+    return 1;
+}
@@ -0,0 +1,149 @@
+#if defined(__linux__)
+#define _GNU_SOURCE /* mremap, MAP_HUGETLB, syscall */
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "sb_huge.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#  include <sys/syscall.h>
+#  if defined(SYS_mbind) && defined(SYS_getcpu)
+#    define SB_HUGE_HAVE_NUMA 1
+#    define SB_HUGE_MPOL_BIND 2 /* MPOL_BIND of <linux/mempolicy.h> */
+#  endif
+#endif
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define SB_HUGE_ROUND(n) (((n) + SB_HUGE_PAGE_SIZE - 1) & ~(SB_HUGE_PAGE_SIZE - 1))
+
+/* --- NUMA binding --- */
+
+/* Binds future faults of [p, p + len) to the node of the calling thread (best effort) */
+static void sb_huge_bind_local(char *p, size_t len){
+#if defined(SB_HUGE_HAVE_NUMA)
+    unsigned long mask[16];
+    unsigned cpu, node;
+
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return;
+    if (node >= sizeof(mask) * 8) return;
+
+    memset(mask, 0, sizeof(mask));
+    mask[node / (sizeof(long) * 8)] = 1ul << (node % (sizeof(long) * 8));
+    /* A refused policy (e.g. no NUMA support) leaves the default one in place */
+    (void)syscall(SYS_mbind, p, len, SB_HUGE_MPOL_BIND, mask, sizeof(mask) * 8, 0);
+#else
+    (void)p; (void)len;
+#endif
+}
+
+/* --- Mappings --- */
+
+/* Anonymous mapping of len bytes (a multiple of SB_HUGE_PAGE_SIZE) */
+static char *sb_huge_map(const SB_HugeAllocator *h, size_t len){
+    char *p;
+    size_t lead;
+
+#if defined(MAP_HUGETLB)
+    if (h->flags & SB_HUGE_HUGETLB) {
+        p = (char*)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != (char*)MAP_FAILED) goto mapped;
+        /* No reserved huge pages: transparent huge pages instead */
+    }
+#endif
+
+    /* Over-map by one huge page and trim, so that the block starts on a huge page boundary */
+    p = (char*)mmap(NULL, len + SB_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == (char*)MAP_FAILED) return NULL;
+    lead = (SB_HUGE_PAGE_SIZE - ((uintptr_t)p & (SB_HUGE_PAGE_SIZE - 1))) & (SB_HUGE_PAGE_SIZE - 1);
+    if (lead) munmap(p, lead);
+    munmap(p + lead + len, SB_HUGE_PAGE_SIZE - lead);
+    p += lead;
+
+#if defined(MADV_HUGEPAGE)
+    madvise(p, len, MADV_HUGEPAGE);
+#endif
+
+#if defined(MAP_HUGETLB)
+mapped:
+#endif
+    if (h->flags & SB_HUGE_NUMA_LOCAL) sb_huge_bind_local(p, len);
+    return p;
+}
+
+/* --- Allocator --- */
+
+static void *sb_huge_alloc(void *ctx, size_t size){
+    const SB_HugeAllocator *h = (const SB_HugeAllocator*)ctx;
+
+    if (size < h->threshold) return malloc(size);
+    return sb_huge_map(h, SB_HUGE_ROUND(size));
+}
+
+static void sb_huge_free(void *ctx, void *ptr, size_t size){
+    const SB_HugeAllocator *h = (const SB_HugeAllocator*)ctx;
+
+    if (size < h->threshold) free(ptr);
+    else if (ptr) munmap(ptr, SB_HUGE_ROUND(size));
+}
+
+static void *sb_huge_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size){
+    const SB_HugeAllocator *h = (const SB_HugeAllocator*)ctx;
+    size_t old_len, new_len;
+    char *p;
+
+    if (old_size < h->threshold && new_size < h->threshold) return realloc(ptr, new_size);
+
+    if (old_size < h->threshold || new_size < h->threshold) {
+        /* Crossing the threshold: one copy between the heap and a mapping */
+        p = (char*)sb_huge_alloc(ctx, new_size);
+        if (!p) return NULL;
+        memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+        sb_huge_free(ctx, ptr, old_size);
+        return p;
+    }
+
+    old_len = SB_HUGE_ROUND(old_size);
+    new_len = SB_HUGE_ROUND(new_size);
+    if (old_len == new_len) return ptr;
+
+#if defined(__linux__)
+    /* Moves page table entries: no copy, in place when the address range allows */
+    p = (char*)mremap(ptr, old_len, new_len, MREMAP_MAYMOVE);
+    if (p != (char*)MAP_FAILED) {
+        if (new_len > old_len && (h->flags & SB_HUGE_NUMA_LOCAL)) sb_huge_bind_local(p + old_len, new_len - old_len);
+        return p;
+    }
+    /* e.g. hugetlb mappings on older kernels: copy instead */
+#endif
+
+    p = sb_huge_map(h, new_len);
+    if (!p) return NULL;
+    memcpy(p, ptr, old_len < new_len ? old_len : new_len);
+    munmap(ptr, old_len);
+    return p;
+}
+
+/* --- Public API --- */
+
+/**
+ * @brief Sets up a huge-page allocator.
+ */
+int sb_huge_allocator_init(SB_HugeAllocator *h, size_t threshold, unsigned flags){
+    if (h == NULL || (flags & ~(SB_HUGE_NUMA_LOCAL | SB_HUGE_HUGETLB))) return 0;
+
+    h->allocator.alloc_fn = sb_huge_alloc;
+    h->allocator.realloc_fn = sb_huge_realloc;
+    h->allocator.free_fn = sb_huge_free;
+    h->allocator.ctx = h;
+    h->threshold = threshold ? threshold : SB_HUGE_DEFAULT_THRESHOLD;
+    h->flags = flags;
+    return 1;
+}
@@ -0,0 +1,146 @@
+#define _POSIX_C_SOURCE 200809L /* writev, sendmsg */
+#include "sb_iovec.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief Fills an iovec array with the contents of a list of buffers.
+ */
+size_t sb_buffer_fill_iovec(SB_Buffer *const *bufs, size_t count, struct iovec *iov, size_t max_iov){
+    SB_IovecCursor c;
+
+    if (!sb_iovec_cursor_init(&c, bufs, count)) return 0;
+    return sb_iovec_cursor_fill(&c, iov, max_iov);
+}
+
+/**
+ * @brief Positions a cursor at the start of a list of buffers.
+ */
+int sb_iovec_cursor_init(SB_IovecCursor *c, SB_Buffer *const *bufs, size_t count){
+    size_t i;
+
+    if (c == NULL || (bufs == NULL && count)) return 0;
+
+    for (i = 0; i < count; i++) {
+        CHECK_SB_BUFFER_POINTER_RET(bufs[i], 0);
+    }
+
+    c->bufs = bufs;
+    c->count = count;
+    c->index = 0;
+    c->offset = 0;
+    return 1;
+}
+
+/**
+ * @brief Fills an iovec array with the data still to be written.
+ */
+size_t sb_iovec_cursor_fill(SB_IovecCursor *c, struct iovec *iov, size_t max_iov){
+    size_t n = 0;
+    size_t i;
+    size_t offset;
+
+    if (c == NULL || iov == NULL) return 0;
+
+    offset = c->offset;
+    for (i = c->index; i < c->count && n < max_iov; i++) {
+        SB_Buffer *b = c->bufs[i];
+
+        if (b->len > offset) {
+            iov[n].iov_base = b->str + offset;
+            iov[n].iov_len = b->len - offset;
+            n++;
+        }
+        offset = 0;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Moves the cursor forward after a (possibly partial) write.
+ */
+int sb_iovec_cursor_advance(SB_IovecCursor *c, size_t written){
+    while (c->index < c->count) {
+        size_t left = c->bufs[c->index]->len - c->offset;
+
+        if (written < left) {
+            c->offset += written;
+            return 0;
+        }
+
+        /* Current buffer fully written: step to the next one */
+        written -= left;
+        c->index++;
+        c->offset = 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Returns whether the cursor reached the end of its buffers.
+ */
+int sb_iovec_cursor_done(const SB_IovecCursor *c){
+    size_t i;
+
+    for (i = c->index; i < c->count; i++) {
+        if (c->bufs[i]->len > (i == c->index ? c->offset : 0)) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief One writev() with the remaining data.
+ */
+ssize_t sb_iovec_writev(int fd, SB_IovecCursor *c){
+    struct iovec iov[SB_IOVEC_BATCH];
+    size_t n = sb_iovec_cursor_fill(c, iov, SB_IOVEC_BATCH);
+    ssize_t w;
+
+    if (n == 0) return 0;
+
+    w = writev(fd, iov, (int)n);
+    if (w > 0) sb_iovec_cursor_advance(c, (size_t)w);
+    return w;
+}
+
+/**
+ * @brief One sendmsg() with the remaining data.
+ */
+ssize_t sb_iovec_sendmsg(int fd, SB_IovecCursor *c, int flags){
+    struct iovec iov[SB_IOVEC_BATCH];
+    struct msghdr msg;
+    size_t n = sb_iovec_cursor_fill(c, iov, SB_IOVEC_BATCH);
+    ssize_t w;
+
+    if (n == 0) return 0;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = n;
+
+    w = sendmsg(fd, &msg, flags);
+    if (w > 0) sb_iovec_cursor_advance(c, (size_t)w);
+    return w;
+}
+
+/**
+ * @brief Writes a list of buffers completely.
+ */
+int sb_buffer_writev_all(int fd, SB_Buffer *const *bufs, size_t count){
+    SB_IovecCursor c;
+
+    if (!sb_iovec_cursor_init(&c, bufs, count)) return 0;
+
+    while (!sb_iovec_cursor_done(&c)) {
+        if (sb_iovec_writev(fd, &c) < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200809L /* sched_yield */
+#include "sb_logbuf.h"
+#include <sched.h>
+#include <string.h>
+
+#define SB_LOGBUF_SIDE_BIT ((uint64_t)1 << 63)
+#define SB_LOGBUF_SPINS 64
+
+#define CHECK_SB_LOGBUF_RET(lb, ret) \
+    do { if ((lb) == NULL || (lb)->magic != SB_LOGBUF_MAGIC) return (ret); } while (0)
+
+/**
+ * @brief Initializes a log buffer with two sides of capacity bytes each.
+ */
+int sb_logbuf_init(SB_LogBuffer *lb, size_t capacity){
+    int i, j;
+
+    if (lb == NULL || capacity == 0 || capacity >= SB_LOGBUF_SIDE_BIT) return 0;
+
+    memset(lb, 0, sizeof(*lb));
+    for (i = 0; i < 2; i++) {
+        SB_BUFFER_INIT_SIZED(&lb->side[i]);
+        if (!sb_buffer_reserve(SB_BUFFER_AS(&lb->side[i]), capacity)) {
+            /* Only the sides initialized so far own a block */
+            for (j = 0; j < i; j++) sb_buffer_finalize(SB_BUFFER_AS(&lb->side[j]));
+            return 0;
+        }
+    }
+    lb->capacity = capacity;
+    lb->magic = SB_LOGBUF_MAGIC;
+    return 1;
+}
+
+/**
+ * @brief Reserves len bytes in the active side.
+ */
+int sb_logbuf_prepare(SB_LogBuffer *lb, size_t len, SB_LogSlot *slot){
+    uint64_t old;
+    size_t off;
+    unsigned side;
+
+    CHECK_SB_LOGBUF_RET(lb, 0);
+    if (slot == NULL) return 0;
+
+    if (len == 0) {
+        slot->ptr = lb->side[0].str;
+        slot->len = 0;
+        slot->side = 0;
+        return 1;
+    }
+    if (len > lb->capacity) {
+        __atomic_fetch_add(&lb->dropped, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    /* One fetch-add picks both the side and the offset: a concurrent swap
+       either sees this reservation or moves it to the new side */
+    old = __atomic_fetch_add(&lb->state, (uint64_t)len, __ATOMIC_ACQ_REL);
+    side = (unsigned)(old >> 63);
+    off = (size_t)(old & ~SB_LOGBUF_SIDE_BIT);
+
+    if (len > lb->capacity - (off < lb->capacity ? off : lb->capacity)) {
+        /* Only the first rejected reservation can start inside the side:
+           it records where the committed data ends */
+        if (off <= lb->capacity) __atomic_store_n(&lb->meta[side].end, off + 1, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&lb->dropped, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    slot->ptr = lb->side[side].str + off;
+    slot->len = len;
+    slot->side = side;
+    return 1;
+}
+
+/**
+ * @brief Publishes the bytes written in a slot.
+ */
+void sb_logbuf_commit(SB_LogBuffer *lb, const SB_LogSlot *slot){
+    if (lb == NULL || slot == NULL) return;
+    __atomic_fetch_add(&lb->meta[slot->side].committed, slot->len, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Appends len bytes as one entry.
+ */
+int sb_logbuf_append(SB_LogBuffer *lb, const char *s, size_t len){
+    SB_LogSlot slot;
+
+    if (s == NULL && len) return 0;
+    if (!sb_logbuf_prepare(lb, len, &slot)) return 0;
+
+    memcpy(slot.ptr, s, len);
+    sb_logbuf_commit(lb, &slot);
+    return 1;
+}
+
+/**
+ * @brief Switches sides and returns the completed one.
+ */
+SB_Buffer *sb_logbuf_swap(SB_LogBuffer *lb){
+    uint64_t old;
+    unsigned side, next;
+    size_t end, spins = 0;
+    SB_Buffer *b;
+
+    CHECK_SB_LOGBUF_RET(lb, NULL);
+
+    /* The next side was handed out by the previous swap: recycle it before
+       producers can reach it */
+    side = (unsigned)(__atomic_load_n(&lb->state, __ATOMIC_RELAXED) >> 63);
+    next = side ^ 1u;
+    lb->meta[next].committed = 0;
+    lb->meta[next].end = 0;
+    sb_buffer_clear(SB_BUFFER_AS(&lb->side[next])); /* Also undoes a consume by the consumer */
+
+    old = __atomic_exchange_n(&lb->state, next ? SB_LOGBUF_SIDE_BIT : 0, __ATOMIC_ACQ_REL);
+    end = (size_t)(old & ~SB_LOGBUF_SIDE_BIT);
+
+    if (end > lb->capacity) {
+        /* The side overflowed: wait for the rejected producer to publish the data end */
+        while ((end = __atomic_load_n(&lb->meta[side].end, __ATOMIC_ACQUIRE)) == 0) {
+            if (++spins > SB_LOGBUF_SPINS) sched_yield();
+        }
+        end--;
+    }
+
+    /* Wait for the producers still writing into the side */
+    while (__atomic_load_n(&lb->meta[side].committed, __ATOMIC_ACQUIRE) != end) {
+        if (++spins > SB_LOGBUF_SPINS) sched_yield();
+    }
+
+    b = SB_BUFFER_AS(&lb->side[side]);
+    b->len = end;
+    b->str[end] = '\0';
+    b->hash = 0;
+    return b;
+}
+
+/**
+ * @brief Bytes currently reserved in the active side.
+ */
+size_t sb_logbuf_pending(SB_LogBuffer *lb){
+    size_t n;
+
+    CHECK_SB_LOGBUF_RET(lb, 0);
+    n = (size_t)(__atomic_load_n(&lb->state, __ATOMIC_RELAXED) & ~SB_LOGBUF_SIDE_BIT);
+    return n < lb->capacity ? n : lb->capacity;
+}
+
+/**
+ * @brief Number of appends dropped so far.
+ */
+uint64_t sb_logbuf_dropped(SB_LogBuffer *lb){
+    CHECK_SB_LOGBUF_RET(lb, 0);
+    return __atomic_load_n(&lb->dropped, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Releases the storage.
+ */
+int sb_logbuf_finalize(SB_LogBuffer *lb){
+    CHECK_SB_LOGBUF_RET(lb, 0);
+
+    sb_buffer_finalize(SB_BUFFER_AS(&lb->side[0]));
+    sb_buffer_finalize(SB_BUFFER_AS(&lb->side[1]));
+    lb->magic = 0;
+    return 1;
+}
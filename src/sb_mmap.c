@@ -0,0 +1,196 @@
+#if defined(__linux__)
+#define _GNU_SOURCE /* mremap */
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "sb_mmap.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* --- Allocator --- */
+
+/* Output mode: (re)maps the file with size bytes */
+static void *sb_mmap_alloc(void *ctx, size_t size){
+    SB_FileMap *m = (SB_FileMap*)ctx;
+    void *p;
+
+    /* Load mode, or a second block: plain heap */
+    if (m->fd < 0 || m->base) return malloc(size);
+
+    if (ftruncate(m->fd, (off_t)size) != 0) return NULL;
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+    if (p == MAP_FAILED) return NULL;
+
+    m->base = (char*)p;
+    m->map_len = size;
+    return p;
+}
+
+static void *sb_mmap_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size){
+    SB_FileMap *m = (SB_FileMap*)ctx;
+    void *p;
+
+    if (ptr != m->base || m->base == NULL) return realloc(ptr, new_size);
+
+    if (m->fd < 0) {
+        /* Load mode: the private mapping cannot grow past the file, move to the heap */
+        p = malloc(new_size);
+        if (!p) return NULL;
+        memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+        munmap(m->base, m->map_len);
+        m->base = NULL;
+        m->map_len = 0;
+        return p;
+    }
+
+    /* Output mode: extend the file first, shrink it last */
+    if (new_size > old_size && ftruncate(m->fd, (off_t)new_size) != 0) return NULL;
+#if defined(__linux__)
+    p = mremap(m->base, m->map_len, new_size, MREMAP_MAYMOVE);
+#else
+    /* Shared file mapping: the content survives an unmap/map cycle */
+    munmap(m->base, m->map_len);
+    p = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+#endif
+    if (p == MAP_FAILED) return NULL;
+    if (new_size < old_size && ftruncate(m->fd, (off_t)new_size) != 0) { /* Only wastes file space */ }
+
+    m->base = (char*)p;
+    m->map_len = new_size;
+    return p;
+}
+
+static void sb_mmap_free(void *ctx, void *ptr, size_t size){
+    SB_FileMap *m = (SB_FileMap*)ctx;
+    (void)size;
+
+    if (ptr == m->base && ptr != NULL) {
+        munmap(m->base, m->map_len);
+        m->base = NULL;
+        m->map_len = 0;
+    } else {
+        free(ptr);
+    }
+}
+
+static void sb_mmap_setup(SB_FileMap *m, int fd){
+    m->allocator.alloc_fn = sb_mmap_alloc;
+    m->allocator.realloc_fn = sb_mmap_realloc;
+    m->allocator.free_fn = sb_mmap_free;
+    m->allocator.ctx = m;
+    m->base = NULL;
+    m->map_len = 0;
+    m->fd = fd;
+}
+
+/* --- Public API --- */
+
+/**
+ * @brief Makes a file the storage of the buffer (output mode).
+ */
+int sb_buffer_map_file(SB_Buffer *b, SB_FileMap *m, const char *path){
+    size_t want;
+    int fd;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (m == NULL || path == NULL) { errno = EINVAL; return 0; }
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+    sb_mmap_setup(m, fd);
+
+    /* The first mapping replaces the inline storage right away */
+    if (!sb_buffer_set_allocator(b, &m->allocator)) goto fail;
+    want = b->len < SB_BUFFER_PAGE_SIZE ? SB_BUFFER_PAGE_SIZE - 1 : b->len;
+    if (b->str == b->init && !sb_buffer_reserve(b, want)) goto fail;
+    return 1;
+
+fail:
+    if (b->alloc == &m->allocator && b->str == b->init) b->alloc = sb_buffer_get_default_allocator();
+    close(fd);
+    m->fd = -1;
+    return 0;
+}
+
+/**
+ * @brief Replaces the content of the buffer with a mapped file (load mode).
+ */
+int sb_buffer_load_file(SB_Buffer *b, SB_FileMap *m, const char *path){
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size, map_len;
+    struct stat st;
+    char *p;
+    int fd;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (m == NULL || path == NULL) { errno = EINVAL; return 0; }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    if (fstat(fd, &st) != 0) { close(fd); return 0; }
+    size = (size_t)st.st_size;
+
+    sb_buffer_reset(b);
+    sb_mmap_setup(m, -1);
+    if (size == 0) {
+        close(fd);
+        b->alloc = &m->allocator;
+        return 1;
+    }
+
+    /* Bytes past the end of file in the last page read as zero: they hold the
+       terminator. When the file fills its last page, an anonymous page follows. */
+    map_len = (size + page - 1) / page * page;
+    if (map_len == size) {
+        map_len += page;
+        p = (char*)mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED &&
+            mmap(p, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(p, map_len);
+            p = (char*)MAP_FAILED;
+        }
+    } else {
+        p = (char*)mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (p == MAP_FAILED) return 0;
+
+    m->base = p;
+    m->map_len = map_len;
+    b->str = p;
+    b->len = size;
+    b->cap = map_len;
+    b->alloc = &m->allocator;
+    return 1;
+}
+
+/**
+ * @brief Detaches a file-backed buffer.
+ */
+int sb_buffer_close_file(SB_Buffer *b){
+    SB_FileMap *m;
+    int ok = 1;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (b->alloc->free_fn != sb_mmap_free) return 0;
+    m = (SB_FileMap*)b->alloc->ctx;
+
+    if (m->fd >= 0) {
+        /* The file starts at the block: drop a consumed head */
+        sb_buffer_compact(b);
+        /* Content still inline (after a shrink): write it out */
+        if (b->str == b->init && b->len && pwrite(m->fd, b->str, b->len, 0) != (ssize_t)b->len) ok = 0;
+        if (ftruncate(m->fd, (off_t)b->len) != 0) ok = 0;
+    }
+
+    sb_buffer_reset(b);
+    if (m->fd >= 0) close(m->fd);
+    m->fd = -1;
+    b->alloc = sb_buffer_get_default_allocator();
+    return ok;
+}
@@ -0,0 +1,334 @@
+#define _POSIX_C_SOURCE 200809L /* pthread */
+#include "sb_pool.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Size classes: 2^9 (SB_POOL_MIN_SIZE) .. 2^20 (SB_POOL_MAX_SIZE) */
+#define SB_POOL_MIN_SHIFT 9
+#define SB_POOL_CLASSES 12
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#  define SB_POOL_TLS _Thread_local
+#elif defined(__GNUC__) || defined(__clang__)
+#  define SB_POOL_TLS __thread
+#else
+#  error "sb_pool requires thread-local storage"
+#endif
+
+/* Counters are written by their owner thread only and read by sb_buffer_pool_stats() */
+#define SB_POOL_COUNT(field) __atomic_store_n(&(field), (field) + 1, __ATOMIC_RELAXED)
+#define SB_POOL_READ(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+/* Header stored inside a cached block */
+typedef struct SB_PoolNode {
+    struct SB_PoolNode *next;
+    size_t cap;
+} SB_PoolNode;
+
+/* Per-thread cache: free lists touched by the owner only */
+typedef struct SB_PoolCache {
+    SB_PoolNode *free[SB_POOL_CLASSES];
+    size_t count[SB_POOL_CLASSES];
+    SB_PoolStats stats;
+    struct SB_PoolCache *prev, *next; /* Registry of live caches */
+    int registered;
+} SB_PoolCache;
+
+static SB_POOL_TLS SB_PoolCache sb_pool_tls;
+
+/* Overflow stage and registry, guarded by lock */
+static struct {
+    pthread_mutex_t lock;
+    SB_PoolNode *free[SB_POOL_CLASSES];
+    size_t count[SB_POOL_CLASSES];
+    SB_PoolStats retired;   /* Counters of exited threads */
+    SB_PoolCache *threads;
+    size_t local_high_water;
+    size_t global_high_water;
+} sb_pool_global = {
+    PTHREAD_MUTEX_INITIALIZER, { NULL }, { 0 }, { 0, 0, 0, 0, 0 }, NULL,
+    SB_POOL_LOCAL_HIGH_WATER, SB_POOL_GLOBAL_HIGH_WATER
+};
+
+static pthread_once_t sb_pool_once = PTHREAD_ONCE_INIT;
+static pthread_key_t sb_pool_key;
+
+static unsigned sb_pool_log2_floor(size_t v){
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - (unsigned)__builtin_clzll((unsigned long long)v);
+#else
+    unsigned n = 0;
+    while (v >>= 1) n++;
+    return n;
+#endif
+}
+
+/* Class able to serve a block of at least size bytes, or -1 above the range */
+static int sb_pool_class_for(size_t size){
+    unsigned shift;
+
+    if (size <= SB_POOL_MIN_SIZE) return 0;
+    if (size > SB_POOL_MAX_SIZE) return -1;
+    shift = sb_pool_log2_floor(size - 1) + 1;
+    return (int)(shift - SB_POOL_MIN_SHIFT);
+}
+
+/* Class a block of cap bytes is filed under, or -1 if it is not pooled */
+static int sb_pool_class_of(size_t cap){
+    if (cap < SB_POOL_MIN_SIZE || cap > SB_POOL_MAX_SIZE) return -1;
+    return (int)(sb_pool_log2_floor(cap) - SB_POOL_MIN_SHIFT);
+}
+
+static void sb_pool_add_stats(SB_PoolStats *dst, SB_PoolStats *src){
+    dst->hits += SB_POOL_READ(src->hits);
+    dst->global_hits += SB_POOL_READ(src->global_hits);
+    dst->misses += SB_POOL_READ(src->misses);
+    dst->releases += SB_POOL_READ(src->releases);
+    dst->drops += SB_POOL_READ(src->drops);
+}
+
+/* Moves the thread cache to the overflow stage (freeing what does not fit) */
+static void sb_pool_flush_locked(SB_PoolCache *c){
+    int k;
+
+    for (k = 0; k < SB_POOL_CLASSES; k++) {
+        while (c->free[k]) {
+            SB_PoolNode *n = c->free[k];
+            c->free[k] = n->next;
+            if (sb_pool_global.count[k] < sb_pool_global.global_high_water) {
+                n->next = sb_pool_global.free[k];
+                sb_pool_global.free[k] = n;
+                sb_pool_global.count[k]++;
+            } else {
+                free(n);
+            }
+        }
+        c->count[k] = 0;
+    }
+}
+
+/* Thread exit: hand the cache over and fold the counters into the totals */
+static void sb_pool_thread_exit(void *arg){
+    SB_PoolCache *c = (SB_PoolCache*)arg;
+
+    pthread_mutex_lock(&sb_pool_global.lock);
+    sb_pool_flush_locked(c);
+    sb_pool_add_stats(&sb_pool_global.retired, &c->stats);
+    if (c->prev) c->prev->next = c->next;
+    else sb_pool_global.threads = c->next;
+    if (c->next) c->next->prev = c->prev;
+    c->registered = 0;
+    pthread_mutex_unlock(&sb_pool_global.lock);
+}
+
+static void sb_pool_make_key(void){
+    pthread_key_create(&sb_pool_key, sb_pool_thread_exit);
+}
+
+/* Returns the calling thread's cache, registering it on first use */
+static SB_PoolCache *sb_pool_cache(void){
+    SB_PoolCache *c = &sb_pool_tls;
+
+    if (SB_BUFFER_LIKELY(c->registered)) return c;
+
+    pthread_once(&sb_pool_once, sb_pool_make_key);
+    pthread_setspecific(sb_pool_key, c);
+
+    pthread_mutex_lock(&sb_pool_global.lock);
+    c->prev = NULL;
+    c->next = sb_pool_global.threads;
+    if (c->next) c->next->prev = c;
+    sb_pool_global.threads = c;
+    c->registered = 1;
+    pthread_mutex_unlock(&sb_pool_global.lock);
+    return c;
+}
+
+/* Takes a block of at least size bytes; *cap receives its real size */
+static char *sb_pool_take(SB_PoolCache *c, size_t size, size_t *cap){
+    int k = sb_pool_class_for(size);
+    SB_PoolNode *n;
+    char *p;
+
+    if (k < 0) {
+        SB_POOL_COUNT(c->stats.misses);
+        *cap = size;
+        return (char*)malloc(size);
+    }
+
+    n = c->free[k];
+    if (n) {
+        c->free[k] = n->next;
+        c->count[k]--;
+        SB_POOL_COUNT(c->stats.hits);
+        *cap = n->cap;
+        return (char*)n;
+    }
+
+    pthread_mutex_lock(&sb_pool_global.lock);
+    n = sb_pool_global.free[k];
+    if (n) {
+        sb_pool_global.free[k] = n->next;
+        sb_pool_global.count[k]--;
+    }
+    pthread_mutex_unlock(&sb_pool_global.lock);
+    if (n) {
+        SB_POOL_COUNT(c->stats.hits);
+        SB_POOL_COUNT(c->stats.global_hits);
+        *cap = n->cap;
+        return (char*)n;
+    }
+
+    /* Miss: allocate the full class size so the block is reusable for the class */
+    SB_POOL_COUNT(c->stats.misses);
+    *cap = (size_t)SB_POOL_MIN_SIZE << k;
+    p = (char*)malloc(*cap);
+    return p;
+}
+
+/* Keeps a block of cap bytes (from malloc) in the pool, or frees it */
+static void sb_pool_give(SB_PoolCache *c, char *p, size_t cap){
+    int k = sb_pool_class_of(cap);
+    SB_PoolNode *n = (SB_PoolNode*)(void*)p;
+    int kept = 0;
+
+    if (k >= 0 && c->count[k] < __atomic_load_n(&sb_pool_global.local_high_water, __ATOMIC_RELAXED)) {
+        n->cap = cap;
+        n->next = c->free[k];
+        c->free[k] = n;
+        c->count[k]++;
+        kept = 1;
+    } else if (k >= 0) {
+        /* Over the thread high-water mark: spill to the overflow stage */
+        pthread_mutex_lock(&sb_pool_global.lock);
+        if (sb_pool_global.count[k] < sb_pool_global.global_high_water) {
+            n->cap = cap;
+            n->next = sb_pool_global.free[k];
+            sb_pool_global.free[k] = n;
+            sb_pool_global.count[k]++;
+            kept = 1;
+        }
+        pthread_mutex_unlock(&sb_pool_global.lock);
+    }
+
+    if (kept) {
+        SB_POOL_COUNT(c->stats.releases);
+    } else {
+        SB_POOL_COUNT(c->stats.drops);
+        free(p);
+    }
+}
+
+/**
+ * @brief Gives the buffer a heap block taken from the pool.
+ */
+int sb_buffer_pool_acquire(SB_Buffer *b, size_t min_len){
+    SB_PoolCache *c;
+    size_t need, cap;
+    char *p;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (min_len < b->len) min_len = b->len;
+    if (min_len >= SIZE_MAX - 1) return 0;
+    need = min_len + SB_BUFFER_TAIL(b);
+    if (need <= b->cap) return 1;
+
+    c = sb_pool_cache();
+    p = sb_pool_take(c, need, &cap);
+    if (!p) return 0;
+
+    memcpy(p, b->str, b->len + SB_BUFFER_TAIL(b));
+    if (b->str != b->init) {
+        if (b->alloc == &sb_buffer_malloc_allocator) sb_pool_give(c, b->str - b->head, b->cap + b->head);
+        else b->alloc->free_fn(b->alloc->ctx, b->str - b->head, b->cap + b->head);
+    }
+
+    b->str = p;
+    b->cap = cap;
+    b->head = 0;
+    b->alloc = &sb_buffer_malloc_allocator;
+    return 1;
+}
+
+/**
+ * @brief Returns the heap block of the buffer to the pool.
+ */
+int sb_buffer_pool_release(SB_Buffer *b){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (b->str != b->init) {
+        if (b->alloc == &sb_buffer_malloc_allocator) sb_pool_give(sb_pool_cache(), b->str - b->head, b->cap + b->head);
+        else b->alloc->free_fn(b->alloc->ctx, b->str - b->head, b->cap + b->head);
+    }
+
+    b->len = 0;
+    b->cap = SB_BUFFER_INLINE_LIMIT(b);
+    b->head = 0;
+    b->hash = 0;
+    b->str = b->init;
+    b->str[0] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Sets the high-water marks.
+ */
+void sb_buffer_pool_set_limits(size_t local_blocks, size_t global_blocks){
+    pthread_mutex_lock(&sb_pool_global.lock);
+    __atomic_store_n(&sb_pool_global.local_high_water, local_blocks, __ATOMIC_RELAXED);
+    sb_pool_global.global_high_water = global_blocks;
+    pthread_mutex_unlock(&sb_pool_global.lock);
+}
+
+/**
+ * @brief Frees the blocks cached by the calling thread and by the overflow stage.
+ */
+void sb_buffer_pool_trim(void){
+    SB_PoolCache *c = &sb_pool_tls;
+    SB_PoolNode *list[SB_POOL_CLASSES];
+    int k;
+
+    for (k = 0; k < SB_POOL_CLASSES; k++) {
+        while (c->free[k]) {
+            SB_PoolNode *n = c->free[k];
+            c->free[k] = n->next;
+            free(n);
+        }
+        c->count[k] = 0;
+    }
+
+    /* Detach the stage under the lock, free outside of it */
+    pthread_mutex_lock(&sb_pool_global.lock);
+    for (k = 0; k < SB_POOL_CLASSES; k++) {
+        list[k] = sb_pool_global.free[k];
+        sb_pool_global.free[k] = NULL;
+        sb_pool_global.count[k] = 0;
+    }
+    pthread_mutex_unlock(&sb_pool_global.lock);
+
+    for (k = 0; k < SB_POOL_CLASSES; k++) {
+        while (list[k]) {
+            SB_PoolNode *n = list[k];
+            list[k] = n->next;
+            free(n);
+        }
+    }
+}
+
+/**
+ * @brief Reads the pool counters.
+ */
+int sb_buffer_pool_stats(SB_PoolStats *stats){
+    SB_PoolCache *c;
+
+    if (stats == NULL) return 0;
+
+    memset(stats, 0, sizeof(*stats));
+    pthread_mutex_lock(&sb_pool_global.lock);
+    sb_pool_add_stats(stats, &sb_pool_global.retired);
+    for (c = sb_pool_global.threads; c; c = c->next) sb_pool_add_stats(stats, &c->stats);
+    pthread_mutex_unlock(&sb_pool_global.lock);
+    return 1;
+}
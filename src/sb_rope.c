@@ -0,0 +1,295 @@
+#include "sb_rope.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Offset of the data area inside a segment (keeps the data aligned) */
+#define SB_ROPE_HDR ((sizeof(SB_RopeSeg) + 15) & ~(size_t)15)
+
+#define SB_ROPE_DATA(seg) ((char*)(seg) + SB_ROPE_HDR)
+
+/**
+ * @brief Links a new empty segment at the tail.
+ */
+static int sb_rope_new_segment(SB_Rope *r){
+    SB_RopeSeg *seg = (SB_RopeSeg*)r->alloc->alloc_fn(r->alloc->ctx, SB_ROPE_HDR + r->seg_size);
+    if (!seg) return 0;
+
+    seg->next = NULL;
+    seg->len = 0;
+
+    if (r->tail) r->tail->next = seg;
+    else r->head = seg;
+
+    r->tail = seg;
+    r->nsegs++;
+    return 1;
+}
+
+/**
+ * @brief Frees every segment from seg on.
+ */
+static void sb_rope_free_after(SB_Rope *r, SB_RopeSeg *seg){
+    SB_RopeSeg *next;
+
+    while (seg) {
+        next = seg->next;
+        r->alloc->free_fn(r->alloc->ctx, seg, SB_ROPE_HDR + r->seg_size);
+        seg = next;
+    }
+}
+
+/**
+ * @brief Undoes a failed append: back to tail holding tail_len bytes (tail NULL: empty rope).
+ */
+static void sb_rope_rollback(SB_Rope *r, SB_RopeSeg *tail, size_t tail_len, size_t len, size_t nsegs){
+    sb_rope_free_after(r, tail ? tail->next : r->head);
+
+    if (tail) {
+        tail->next = NULL;
+        tail->len = tail_len;
+    } else {
+        r->head = NULL;
+    }
+
+    r->tail = tail;
+    r->len = len;
+    r->nsegs = nsegs;
+}
+
+/**
+ * @brief Initializes an empty rope.
+ */
+int sb_rope_init(SB_Rope *r, size_t seg_size){
+    if (r == NULL) return 0;
+
+    r->magic = SB_ROPE_MAGIC;
+    r->head = r->tail = NULL;
+    r->len = 0;
+    r->seg_size = seg_size ? seg_size : SB_ROPE_SEGMENT_SIZE;
+    r->nsegs = 0;
+    r->alloc = sb_buffer_get_default_allocator();
+
+    return 1;
+}
+
+/**
+ * @brief Appends a string of known length, filling the newest segment first.
+ */
+int sb_rope_add_lstring(SB_Rope *r, const char *s, size_t len){
+    SB_RopeSeg *tail;
+    size_t tail_len, old_len, old_nsegs;
+
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+
+    if (s == NULL && len) return 0;
+
+    tail = r->tail;
+    tail_len = tail ? tail->len : 0;
+    old_len = r->len;
+    old_nsegs = r->nsegs;
+
+    while (len > 0) {
+        size_t room, n;
+
+        if (r->tail == NULL || r->tail->len == r->seg_size) {
+            if (!sb_rope_new_segment(r)) {
+                /* All or nothing: drop the part already copied */
+                sb_rope_rollback(r, tail, tail_len, old_len, old_nsegs);
+                return 0;
+            }
+        }
+
+        room = r->seg_size - r->tail->len;
+        n = len < room ? len : room;
+
+        memcpy(SB_ROPE_DATA(r->tail) + r->tail->len, s, n);
+        r->tail->len += n;
+        r->len += n;
+        s += n;
+        len -= n;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Appends a single character.
+ */
+int sb_rope_add_char(SB_Rope *r, char c){
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+
+    if ((r->tail == NULL || r->tail->len == r->seg_size) && !sb_rope_new_segment(r)) return 0;
+
+    SB_ROPE_DATA(r->tail)[r->tail->len++] = c;
+    r->len++;
+    return 1;
+}
+
+/**
+ * @brief printf-style append into the newest segment, or through a temporary buffer.
+ */
+int sb_rope_vappendf(SB_Rope *r, const char *fmt, va_list ap){
+    SB_Buffer tmp;
+    va_list ap2;
+    int n, ok;
+
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+
+    if (fmt == NULL) return 0;
+
+    /* First attempt: format in place in what is left of the newest segment */
+    if (r->tail && r->tail->len < r->seg_size) {
+        size_t room = r->seg_size - r->tail->len;
+
+        va_copy(ap2, ap);
+        n = vsnprintf(SB_ROPE_DATA(r->tail) + r->tail->len, room, fmt, ap2);
+        va_end(ap2);
+
+        if (n < 0) return 0;
+        if ((size_t)n < room) {
+            r->tail->len += (size_t)n;
+            r->len += (size_t)n;
+            return 1;
+        }
+    }
+
+    /* Did not fit (vsnprintf needs room for its terminator): format once, then split */
+    sb_buffer_init(&tmp);
+    sb_buffer_set_allocator(&tmp, r->alloc);
+    ok = sb_buffer_vappendf(&tmp, fmt, ap) && sb_rope_add_lstring(r, tmp.str, tmp.len);
+    sb_buffer_finalize(&tmp);
+
+    return ok;
+}
+
+/**
+ * @brief printf-style append (variadic front end of sb_rope_vappendf).
+ */
+int sb_rope_appendf(SB_Rope *r, const char *fmt, ...){
+    va_list ap;
+    int ret;
+
+    va_start(ap, fmt);
+    ret = sb_rope_vappendf(r, fmt, ap);
+    va_end(ap);
+
+    return ret;
+}
+
+/**
+ * @brief Returns the total length of the content.
+ */
+size_t sb_rope_get_len(SB_Rope *r){
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+    return r->len;
+}
+
+/**
+ * @brief Copies the whole content into dest with one reserve.
+ */
+int sb_rope_flatten(SB_Rope *r, SB_Buffer *dest){
+    const SB_RopeSeg *seg;
+    char *p;
+
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+
+    p = sb_buffer_prepare(dest, r->len);
+    if (!p) return 0;
+
+    for (seg = r->head; seg; seg = seg->next) {
+        memcpy(p, SB_ROPE_DATA(seg), seg->len);
+        p += seg->len;
+    }
+
+    return sb_buffer_commit(dest, r->len);
+}
+
+/**
+ * @brief Copies the whole content into a single allocation.
+ */
+char *sb_rope_flatten_alloc(SB_Rope *r, size_t *out_len){
+    const SB_RopeSeg *seg;
+    char *block, *p;
+
+    CHECK_SB_ROPE_POINTER_RET(r, NULL);
+
+    block = (char*)r->alloc->alloc_fn(r->alloc->ctx, r->len + 1);
+    if (!block) return NULL;
+
+    p = block;
+    for (seg = r->head; seg; seg = seg->next) {
+        memcpy(p, SB_ROPE_DATA(seg), seg->len);
+        p += seg->len;
+    }
+    *p = '\0';
+
+    if (out_len) *out_len = r->len;
+    return block;
+}
+
+/* --- Iteration --- */
+
+const SB_RopeSeg *sb_rope_first(const SB_Rope *r){
+    return r ? r->head : NULL;
+}
+
+const SB_RopeSeg *sb_rope_next(const SB_RopeSeg *seg){
+    return seg ? seg->next : NULL;
+}
+
+const char *sb_rope_seg_data(const SB_RopeSeg *seg){
+    return SB_ROPE_DATA(seg);
+}
+
+/**
+ * @brief Fills an SB_Slice array with the non-empty segments.
+ */
+size_t sb_rope_fill_slices(SB_Rope *r, SB_Slice *out, size_t max){
+    const SB_RopeSeg *seg;
+    size_t n = 0;
+
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+
+    for (seg = r->head; seg && n < max; seg = seg->next) {
+        if (seg->len == 0) continue;
+        out[n].base = SB_ROPE_DATA(seg);
+        out[n].len = seg->len;
+        n++;
+    }
+
+    return n;
+}
+
+/* --- Cleanup --- */
+
+/**
+ * @brief Empties the rope, keeping the first segment.
+ */
+int sb_rope_clear(SB_Rope *r){
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+
+    if (r->head) {
+        sb_rope_free_after(r, r->head->next);
+        r->head->next = NULL;
+        r->head->len = 0;
+        r->tail = r->head;
+        r->nsegs = 1;
+    }
+
+    r->len = 0;
+    return 1;
+}
+
+/**
+ * @brief Releases every segment.
+ */
+int sb_rope_finalize(SB_Rope *r){
+    CHECK_SB_ROPE_POINTER_RET(r, 0);
+
+    sb_rope_free_after(r, r->head);
+    r->head = r->tail = NULL;
+    r->nsegs = 0;
+    r->len = 0;
+
+    return 1;
+}
@@ -0,0 +1,572 @@
+#include "sb_search.h"
+#include "sb_simd.h"
+#include <string.h>
+
+/* Sets larger than this are matched with a 256-entry table instead of vectors */
+#define SB_SEARCH_SIMD_SET 16
+
+/* glibc's memchr is already vectorized (and measured faster in sb_bench):
+   on glibc the x86 families keep it for single-byte searches */
+#if defined(__GLIBC__)
+#define SB_SEARCH_LIBC_MEMCHR 1
+#endif
+
+typedef struct {
+    const char *name;
+    size_t (*byte)(const char *p, size_t n, char c);
+    size_t (*any)(const char *p, size_t n, const char *set, size_t k);
+    size_t (*count)(const char *p, size_t n, char c);
+    size_t (*mem)(const char *p, size_t n, const char *needle, size_t m);
+} SB_SearchKernels;
+
+/* --- Scalar kernels --- */
+
+static size_t sb_scalar_byte(const char *p, size_t n, char c){
+    const char *r = (const char*)memchr(p, c, n);
+    return r ? (size_t)(r - p) : SB_BUFFER_NPOS;
+}
+
+static size_t sb_scalar_any(const char *p, size_t n, const char *set, size_t k){
+    unsigned char table[256];
+    size_t i;
+
+    memset(table, 0, sizeof(table));
+    for (i = 0; i < k; i++) table[(unsigned char)set[i]] = 1;
+
+    for (i = 0; i < n; i++) {
+        if (table[(unsigned char)p[i]]) return i;
+    }
+    return SB_BUFFER_NPOS;
+}
+
+static size_t sb_scalar_count(const char *p, size_t n, char c){
+    size_t i, count = 0;
+
+    for (i = 0; i < n; i++) count += (p[i] == c);
+    return count;
+}
+
+/* Checks a candidate position whose first and last bytes already match */
+static int sb_match_inner(const char *p, const char *needle, size_t m){
+    return m <= 2 || memcmp(p + 1, needle + 1, m - 2) == 0;
+}
+
+static size_t sb_scalar_mem(const char *p, size_t n, const char *needle, size_t m){
+    size_t i;
+
+    for (i = 0; i + m <= n; i++) {
+        const char *r = (const char*)memchr(p + i, needle[0], n - m + 1 - i);
+        if (!r) break;
+        i = (size_t)(r - p);
+        if (p[i + m - 1] == needle[m - 1] && sb_match_inner(p + i, needle, m)) return i;
+    }
+    return SB_BUFFER_NPOS;
+}
+
+static const SB_SearchKernels sb_kernels_scalar = {
+    "scalar", sb_scalar_byte, sb_scalar_any, sb_scalar_count, sb_scalar_mem
+};
+
+/* --- SSE2 kernels --- */
+
+#if defined(SB_SIMD_SSE2)
+
+#if !defined(SB_SEARCH_LIBC_MEMCHR)
+static size_t sb_sse2_byte(const char *p, size_t n, char c){
+    __m128i v = _mm_set1_epi8(c);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i)), v));
+        if (m) return i + SB_CTZ(m);
+    }
+    for (; i < n; i++) if (p[i] == c) return i;
+    return SB_BUFFER_NPOS;
+}
+#endif
+
+static size_t sb_sse2_any(const char *p, size_t n, const char *set, size_t k){
+    __m128i v[SB_SEARCH_SIMD_SET];
+    size_t i = 0, j;
+
+    if (k > SB_SEARCH_SIMD_SET) return sb_scalar_any(p, n, set, k);
+    for (j = 0; j < k; j++) v[j] = _mm_set1_epi8(set[j]);
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i hit = _mm_setzero_si128();
+        unsigned m;
+        for (j = 0; j < k; j++) hit = _mm_or_si128(hit, _mm_cmpeq_epi8(x, v[j]));
+        m = (unsigned)_mm_movemask_epi8(hit);
+        if (m) return i + SB_CTZ(m);
+    }
+    j = sb_scalar_any(p + i, n - i, set, k);
+    return j == SB_BUFFER_NPOS ? j : i + j;
+}
+
+static size_t sb_sse2_count(const char *p, size_t n, char c){
+    __m128i v = _mm_set1_epi8(c);
+    size_t i = 0, count = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i)), v));
+        count += SB_POPCOUNT(m);
+    }
+    return count + sb_scalar_count(p + i, n - i, c);
+}
+
+static size_t sb_sse2_mem(const char *p, size_t n, const char *needle, size_t m){
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[m - 1]);
+    size_t i = 0, j;
+
+    /* Candidates: positions where both the first and the last byte match */
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i)), first);
+        __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i + m - 1)), last);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(a, b));
+        while (mask) {
+            unsigned bit = SB_CTZ(mask);
+            if (sb_match_inner(p + i + bit, needle, m)) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    j = sb_scalar_mem(p + i, n - i, needle, m);
+    return j == SB_BUFFER_NPOS ? j : i + j;
+}
+
+#if defined(SB_SEARCH_LIBC_MEMCHR)
+#define sb_sse2_byte_best sb_scalar_byte
+#else
+#define sb_sse2_byte_best sb_sse2_byte
+#endif
+
+static const SB_SearchKernels sb_kernels_sse2 = {
+    "sse2", sb_sse2_byte_best, sb_sse2_any, sb_sse2_count, sb_sse2_mem
+};
+
+#endif /* SB_SIMD_SSE2 */
+
+/* --- AVX2 kernels --- */
+
+#if defined(SB_SIMD_AVX2)
+
+#if !defined(SB_SEARCH_LIBC_MEMCHR)
+SB_TARGET_AVX2 static size_t sb_avx2_byte(const char *p, size_t n, char c){
+    __m256i v = _mm256_set1_epi8(c);
+    size_t i = 0;
+
+    /* Main loop: 128 bytes per iteration, a single branch on the merged result */
+    for (; i + 128 <= n; i += 128) {
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), v);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 32)), v);
+        __m256i c2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 64)), v);
+        __m256i d = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 96)), v);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c2, d));
+        if (!_mm256_testz_si256(any, any)) {
+            uint64_t lo = (uint64_t)(unsigned)_mm256_movemask_epi8(a)
+                        | (uint64_t)(unsigned)_mm256_movemask_epi8(b) << 32;
+            uint64_t hi = (uint64_t)(unsigned)_mm256_movemask_epi8(c2)
+                        | (uint64_t)(unsigned)_mm256_movemask_epi8(d) << 32;
+            return lo ? i + SB_CTZ(lo) : i + 64 + SB_CTZ(hi);
+        }
+    }
+    for (; i + 32 <= n; i += 32) {
+        unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), v));
+        if (m) return i + SB_CTZ(m);
+    }
+    for (; i < n; i++) if (p[i] == c) return i;
+    return SB_BUFFER_NPOS;
+}
+#endif
+
+SB_TARGET_AVX2 static size_t sb_avx2_any(const char *p, size_t n, const char *set, size_t k){
+    __m256i v[SB_SEARCH_SIMD_SET];
+    size_t i = 0, j;
+
+    if (k > SB_SEARCH_SIMD_SET) return sb_scalar_any(p, n, set, k);
+    for (j = 0; j < k; j++) v[j] = _mm256_set1_epi8(set[j]);
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i hit = _mm256_setzero_si256();
+        unsigned m;
+        for (j = 0; j < k; j++) hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(x, v[j]));
+        m = (unsigned)_mm256_movemask_epi8(hit);
+        if (m) return i + SB_CTZ(m);
+    }
+    j = sb_scalar_any(p + i, n - i, set, k);
+    return j == SB_BUFFER_NPOS ? j : i + j;
+}
+
+SB_TARGET_AVX2 static size_t sb_avx2_count(const char *p, size_t n, char c){
+    __m256i v = _mm256_set1_epi8(c);
+    size_t i = 0, count = 0;
+
+    /* Matches are 0xFF (-1): subtracting them counts per byte lane; flush
+       the lanes with a sum of absolute differences before they overflow */
+    while (i + 32 <= n) {
+        __m256i acc = _mm256_setzero_si256();
+        size_t end = n - i >= 255 * 32 ? i + 255 * 32 : i + ((n - i) & ~(size_t)31);
+        __m256i sums;
+        for (; i < end; i += 32) {
+            acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), v));
+        }
+        sums = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+        count += (size_t)_mm256_extract_epi64(sums, 0) + (size_t)_mm256_extract_epi64(sums, 1)
+               + (size_t)_mm256_extract_epi64(sums, 2) + (size_t)_mm256_extract_epi64(sums, 3);
+    }
+    return count + sb_scalar_count(p + i, n - i, c);
+}
+
+SB_TARGET_AVX2 static size_t sb_avx2_mem(const char *p, size_t n, const char *needle, size_t m){
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    size_t i = 0, j;
+
+    for (; i + m - 1 + 64 <= n; i += 64) {
+        /* Two blocks per iteration; candidates are rare, so test them together */
+        __m256i a0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), first);
+        __m256i b0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + m - 1)), last);
+        __m256i a1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + 32)), first);
+        __m256i b1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + m + 31)), last);
+        uint64_t mask = (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_and_si256(a0, b0))
+                      | (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_and_si256(a1, b1)) << 32;
+        while (mask) {
+            unsigned bit = SB_CTZ(mask);
+            if (sb_match_inner(p + i + bit, needle, m)) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i)), first);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + i + m - 1)), last);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(a, b));
+        while (mask) {
+            unsigned bit = SB_CTZ(mask);
+            if (sb_match_inner(p + i + bit, needle, m)) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    j = sb_scalar_mem(p + i, n - i, needle, m);
+    return j == SB_BUFFER_NPOS ? j : i + j;
+}
+
+#if defined(SB_SEARCH_LIBC_MEMCHR)
+#define sb_avx2_byte_best sb_scalar_byte
+#else
+#define sb_avx2_byte_best sb_avx2_byte
+#endif
+
+static const SB_SearchKernels sb_kernels_avx2 = {
+    "avx2", sb_avx2_byte_best, sb_avx2_any, sb_avx2_count, sb_avx2_mem
+};
+
+#endif /* SB_SIMD_AVX2 */
+
+/* --- NEON kernels --- */
+
+#if defined(SB_SIMD_NEON)
+
+static size_t sb_neon_byte(const char *p, size_t n, char c){
+    uint8x16_t v = vdupq_n_u8((uint8_t)c);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        uint64_t m = sb_neon_mask(vceqq_u8(vld1q_u8((const uint8_t*)p + i), v));
+        if (m) return i + SB_CTZ(m) / 4;
+    }
+    for (; i < n; i++) if (p[i] == c) return i;
+    return SB_BUFFER_NPOS;
+}
+
+static size_t sb_neon_any(const char *p, size_t n, const char *set, size_t k){
+    uint8x16_t v[SB_SEARCH_SIMD_SET];
+    size_t i = 0, j;
+
+    if (k > SB_SEARCH_SIMD_SET) return sb_scalar_any(p, n, set, k);
+    for (j = 0; j < k; j++) v[j] = vdupq_n_u8((uint8_t)set[j]);
+
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t x = vld1q_u8((const uint8_t*)p + i);
+        uint8x16_t hit = vdupq_n_u8(0);
+        uint64_t m;
+        for (j = 0; j < k; j++) hit = vorrq_u8(hit, vceqq_u8(x, v[j]));
+        m = sb_neon_mask(hit);
+        if (m) return i + SB_CTZ(m) / 4;
+    }
+    j = sb_scalar_any(p + i, n - i, set, k);
+    return j == SB_BUFFER_NPOS ? j : i + j;
+}
+
+static size_t sb_neon_count(const char *p, size_t n, char c){
+    uint8x16_t v = vdupq_n_u8((uint8_t)c);
+    size_t i = 0, count = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        /* Each match is 0xFF: shifting right by 7 turns it into 1 */
+        count += vaddvq_u8(vshrq_n_u8(vceqq_u8(vld1q_u8((const uint8_t*)p + i), v), 7));
+    }
+    return count + sb_scalar_count(p + i, n - i, c);
+}
+
+static size_t sb_neon_mem(const char *p, size_t n, const char *needle, size_t m){
+    uint8x16_t first = vdupq_n_u8((uint8_t)needle[0]);
+    uint8x16_t last = vdupq_n_u8((uint8_t)needle[m - 1]);
+    size_t i = 0, j;
+
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        uint8x16_t a = vceqq_u8(vld1q_u8((const uint8_t*)p + i), first);
+        uint8x16_t b = vceqq_u8(vld1q_u8((const uint8_t*)p + i + m - 1), last);
+        uint64_t mask = sb_neon_mask(vandq_u8(a, b)) & 0x1111111111111111ULL;
+        while (mask) {
+            unsigned bit = SB_CTZ(mask) / 4;
+            if (sb_match_inner(p + i + bit, needle, m)) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    j = sb_scalar_mem(p + i, n - i, needle, m);
+    return j == SB_BUFFER_NPOS ? j : i + j;
+}
+
+static const SB_SearchKernels sb_kernels_neon = {
+    "neon", sb_neon_byte, sb_neon_any, sb_neon_count, sb_neon_mem
+};
+
+#endif /* SB_SIMD_NEON */
+
+/* --- Dispatch --- */
+
+/**
+ * @brief Selects the best kernel family for the running CPU (once).
+ */
+static const SB_SearchKernels *sb_search_active = NULL;
+
+static const SB_SearchKernels *sb_search_kernels(void){
+    const SB_SearchKernels *k = sb_search_active;
+
+    if (k == NULL) {
+#if defined(SB_SIMD_AVX2)
+        if (sb_simd_has_avx2()) k = &sb_kernels_avx2;
+        else k = &sb_kernels_sse2;
+#elif defined(SB_SIMD_SSE2)
+        k = &sb_kernels_sse2;
+#elif defined(SB_SIMD_NEON)
+        k = &sb_kernels_neon;
+#else
+        k = &sb_kernels_scalar;
+#endif
+        sb_search_active = k;
+    }
+    return k;
+}
+
+const char *sb_search_kernel_name(void){
+    return sb_search_kernels()->name;
+}
+
+/* Kernel families compiled into this build, best first */
+static const SB_SearchKernels *const sb_kernels_all[] = {
+#if defined(SB_SIMD_AVX2)
+    &sb_kernels_avx2,
+#endif
+#if defined(SB_SIMD_SSE2)
+    &sb_kernels_sse2,
+#endif
+#if defined(SB_SIMD_NEON)
+    &sb_kernels_neon,
+#endif
+    &sb_kernels_scalar
+};
+
+int sb_search_set_kernel(const char *name){
+    size_t i;
+
+    if (name == NULL) {
+        sb_search_active = NULL;
+        sb_search_kernels();
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(sb_kernels_all) / sizeof(sb_kernels_all[0]); i++) {
+        if (strcmp(sb_kernels_all[i]->name, name) != 0) continue;
+#if defined(SB_SIMD_AVX2)
+        if (sb_kernels_all[i] == &sb_kernels_avx2 && !sb_simd_has_avx2()) return 0;
+#endif
+        sb_search_active = sb_kernels_all[i];
+        return 1;
+    }
+    return 0;
+}
+
+/* --- Raw memory kernels --- */
+
+size_t sb_search_byte(const char *p, size_t n, char c){
+    return sb_search_kernels()->byte(p, n, c);
+}
+
+size_t sb_search_any(const char *p, size_t n, const char *set){
+    size_t k = strlen(set);
+
+    if (k == 0) return SB_BUFFER_NPOS;
+    if (k == 1) return sb_search_kernels()->byte(p, n, set[0]);
+    return sb_search_kernels()->any(p, n, set, k);
+}
+
+size_t sb_search_count(const char *p, size_t n, char c){
+    return sb_search_kernels()->count(p, n, c);
+}
+
+size_t sb_search_mem(const char *p, size_t n, const char *needle, size_t m){
+    if (m == 0) return 0;
+    if (m > n) return SB_BUFFER_NPOS;
+    if (m == 1) return sb_search_kernels()->byte(p, n, needle[0]);
+    return sb_search_kernels()->mem(p, n, needle, m);
+}
+
+/* --- Buffer API --- */
+
+/* Converts a match relative to start back to a buffer offset */
+static size_t sb_search_offset(size_t r, size_t start){
+    return r == SB_BUFFER_NPOS ? r : r + start;
+}
+
+size_t sb_buffer_find(SB_Buffer *b, size_t start, const char *needle, size_t nlen){
+    CHECK_SB_BUFFER_POINTER_RET(b, SB_BUFFER_NPOS);
+
+    if (start > b->len || (needle == NULL && nlen)) return SB_BUFFER_NPOS;
+    return sb_search_offset(sb_search_mem(b->str + start, b->len - start, needle, nlen), start);
+}
+
+size_t sb_buffer_find_char(SB_Buffer *b, size_t start, char c){
+    CHECK_SB_BUFFER_POINTER_RET(b, SB_BUFFER_NPOS);
+
+    if (start >= b->len) return SB_BUFFER_NPOS;
+    return sb_search_offset(sb_search_byte(b->str + start, b->len - start, c), start);
+}
+
+size_t sb_buffer_find_any(SB_Buffer *b, size_t start, const char *charset){
+    CHECK_SB_BUFFER_POINTER_RET(b, SB_BUFFER_NPOS);
+
+    if (start >= b->len || charset == NULL) return SB_BUFFER_NPOS;
+    return sb_search_offset(sb_search_any(b->str + start, b->len - start, charset), start);
+}
+
+size_t sb_buffer_count_char(SB_Buffer *b, char c){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    return sb_search_count(b->str, b->len, c);
+}
+
+/* --- Replace --- */
+
+/*
+ * Replaces every match while copying the content forward once. src holds
+ * the original content (len bytes) and dst <= src; when the replacement is
+ * longer, the caller parked src at the end of the block so that writing it
+ * never catches up with reading it.
+ */
+static size_t sb_replace_pass(char *dst, const char *src, size_t len,
+                              const char *from, size_t flen, const char *to, size_t tlen){
+    size_t r = 0, w = 0, at;
+
+    while ((at = sb_search_mem(src + r, len - r, from, flen)) != SB_BUFFER_NPOS) {
+        memmove(dst + w, src + r, at);
+        w += at;
+        memcpy(dst + w, to, tlen);
+        w += tlen;
+        r += at + flen;
+    }
+    memmove(dst + w, src + r, len - r);
+    return w + len - r;
+}
+
+int sb_buffer_replace_all(SB_Buffer *b, const char *from, size_t flen, const char *to, size_t tlen){
+    size_t count = 0, r = 0, at, newlen;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (from == NULL || flen == 0 || (to == NULL && tlen)) return 0;
+
+    /* Same length or shorter: in place, front to back */
+    if (tlen <= flen) {
+        b->len = sb_replace_pass(b->str, b->str, b->len, from, flen, to, tlen);
+        SB_BUFFER_TERMINATE(b);
+        b->hash = 0;
+        return 1;
+    }
+
+    /* Longer: count the matches to grow exactly once */
+    while ((at = sb_search_mem(b->str + r, b->len - r, from, flen)) != SB_BUFFER_NPOS) {
+        r += at + flen;
+        count++;
+    }
+    if (count == 0) return 1;
+    if (count > ((size_t)-1 / 2 - b->len) / (tlen - flen)) return 0;
+    newlen = b->len + count * (tlen - flen);
+    if (!sb_buffer_reserve(b, newlen)) return 0;
+
+    /* Park the content at the end of the block, then rebuild it from the front */
+    memmove(b->str + (newlen - b->len), b->str, b->len);
+    sb_replace_pass(b->str, b->str + (newlen - b->len), b->len, from, flen, to, tlen);
+    b->len = newlen;
+    SB_BUFFER_TERMINATE(b);
+    b->hash = 0;
+    return 1;
+}
+
+/* --- Tokenizer --- */
+
+int sb_tokenizer_init(SB_Tokenizer *t, SB_Buffer *b, const char *delims){
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+
+    if (t == NULL || delims == NULL) return 0;
+
+    t->str = b->str;
+    t->len = b->len;
+    t->pos = 0;
+    t->delims = delims;
+    t->done = 0;
+    return 1;
+}
+
+int sb_tokenizer_next(SB_Tokenizer *t, SB_Slice *field){
+    size_t r;
+
+    if (t == NULL || field == NULL || t->done) return 0;
+
+    r = sb_search_any(t->str + t->pos, t->len - t->pos, t->delims);
+    field->base = t->str + t->pos;
+
+    if (r == SB_BUFFER_NPOS) {
+        /* Last field: runs to the end of the content */
+        field->len = t->len - t->pos;
+        t->pos = t->len;
+        t->done = 1;
+    } else {
+        field->len = r;
+        t->pos += r + 1;
+    }
+    return 1;
+}
+
+int sb_tokenizer_next_line(SB_Tokenizer *t, SB_Slice *line){
+    size_t r, n;
+
+    if (t == NULL || line == NULL || t->done || t->pos >= t->len) return 0;
+
+    r = sb_search_byte(t->str + t->pos, t->len - t->pos, '\n');
+    line->base = t->str + t->pos;
+
+    if (r == SB_BUFFER_NPOS) {
+        n = t->len - t->pos;
+        t->pos = t->len;
+        t->done = 1;
+    } else {
+        n = r;
+        t->pos += r + 1;
+    }
+
+    /* Strip the CR of a CRLF terminator */
+    if (n > 0 && ((const char*)line->base)[n - 1] == '\r') n--;
+    line->len = n;
+    return 1;
+}
@@ -0,0 +1,77 @@
+/*
+ * Internal SIMD helpers shared by the vectorized kernels (not installed).
+ *
+ * SB_SIMD_SSE2 : SSE2 kernels are compiled (baseline on x86-64).
+ * SB_SIMD_AVX2 : AVX2 kernels are compiled with a target attribute and are
+ *                only called when the CPU reports AVX2 at run time.
+ * SB_SIMD_NEON : NEON kernels are compiled (baseline on AArch64).
+ *
+ * Define SB_BUFFER_NO_SIMD to build the portable scalar code only.
+ */
+#ifndef SB_SIMD_H
+#define SB_SIMD_H
+
+#include "sb_buffer.h" /* For SB_BUFFER_INLINE, uint64_t */
+
+#if !defined(SB_BUFFER_NO_SIMD)
+#  if defined(__SSE2__) || defined(_M_X64)
+#    define SB_SIMD_SSE2 1
+#    include <emmintrin.h>
+#    if defined(__GNUC__) || defined(__clang__)
+#      define SB_SIMD_AVX2 1
+#      include <immintrin.h>
+#      define SB_TARGET_AVX2 __attribute__((target("avx2")))
+#      define SB_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    endif
+#  elif defined(__ARM_NEON) || defined(__aarch64__)
+#    define SB_SIMD_NEON 1
+#    include <arm_neon.h>
+#  endif
+#endif
+
+/* Index of the lowest set bit / number of set bits of a non-zero 64-bit mask */
+#if defined(__GNUC__) || defined(__clang__)
+#  define SB_CTZ(x) ((unsigned)__builtin_ctzll(x))
+#  define SB_POPCOUNT(x) ((unsigned)__builtin_popcountll(x))
+#else
+SB_BUFFER_INLINE unsigned sb_ctz_portable(uint64_t x){ unsigned n = 0; while (!(x & 1u)) { x >>= 1; n++; } return n; }
+SB_BUFFER_INLINE unsigned sb_popcount_portable(uint64_t x){ unsigned n = 0; while (x) { x &= x - 1; n++; } return n; }
+#  define SB_CTZ(x) sb_ctz_portable(x)
+#  define SB_POPCOUNT(x) sb_popcount_portable(x)
+#endif
+
+/*
+ * Returns 1 when the running CPU supports AVX2 (cached after the first call).
+ */
+#if defined(SB_SIMD_AVX2)
+SB_BUFFER_INLINE int sb_simd_has_avx2(void){
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+}
+
+/*
+ * Returns 1 when the running CPU supports SSSE3 (pshufb).
+ */
+SB_BUFFER_INLINE int sb_simd_has_ssse3(void){
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+    return cached;
+}
+#endif
+
+#if defined(SB_SIMD_NEON)
+/* Equivalent of _mm_movemask_epi8 for a 0x00/0xFF byte mask: 4 bits per byte */
+SB_BUFFER_INLINE uint64_t sb_neon_mask(uint8x16_t m){
+    uint8x8_t n = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(n), 0);
+}
+#endif
+
+#endif /* SB_SIMD_H */
@@ -0,0 +1,50 @@
+#define _POSIX_C_SOURCE 200809L /* write */
+#include "sb_sink.h"
+#include <errno.h>
+#include <unistd.h>
+
+static int sb_fd_sink_write(void *ctx, const char *data, size_t len){
+    SB_FdSink *s = (SB_FdSink*)ctx;
+
+    while (len) {
+        ssize_t n = write(s->fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        data += n;
+        len -= (size_t)n;
+        s->written += (uint64_t)n;
+    }
+    return 1;
+}
+
+/**
+ * @brief Initializes a file descriptor sink.
+ */
+SB_Sink *sb_fd_sink_init(SB_FdSink *s, int fd){
+    if (s == NULL) return NULL;
+
+    s->sink.write_fn = sb_fd_sink_write;
+    s->sink.ctx = s;
+    s->sink.high_water = 0;
+    s->fd = fd;
+    s->written = 0;
+    return &s->sink;
+}
+
+static int sb_stdio_sink_write(void *ctx, const char *data, size_t len){
+    return fwrite(data, 1, len, (FILE*)ctx) == len;
+}
+
+/**
+ * @brief Initializes a sink writing to a stdio stream.
+ */
+SB_Sink *sb_stdio_sink_init(SB_Sink *s, FILE *f){
+    if (s == NULL || f == NULL) return NULL;
+
+    s->write_fn = sb_stdio_sink_write;
+    s->ctx = f;
+    s->high_water = 0;
+    return s;
+}
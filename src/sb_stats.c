@@ -0,0 +1,193 @@
+#define _POSIX_C_SOURCE 200809L /* pthread */
+#include "sb_stats.h"
+#include "sb_stats_hooks.h"
+#include <string.h>
+
+#if defined(SB_BUFFER_STATS)
+
+#include <pthread.h>
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#  define SB_STATS_TLS _Thread_local
+#else
+#  define SB_STATS_TLS __thread
+#endif
+
+/* Counters are written by their owner thread only and read by sb_buffer_stats_get() */
+#define SB_STATS_ADD(field, v) __atomic_store_n(&(field), (field) + (v), __ATOMIC_RELAXED)
+#define SB_STATS_READ(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+typedef struct SB_StatsThread {
+    SB_BufferStats c;
+    struct SB_StatsThread *prev, *next; /* Registry of live threads */
+    int registered;
+} SB_StatsThread;
+
+static SB_STATS_TLS SB_StatsThread sb_stats_tls;
+
+static struct {
+    pthread_mutex_t lock;
+    SB_BufferStats retired; /* Counters of exited threads */
+    SB_StatsThread *threads;
+} sb_stats_global = { PTHREAD_MUTEX_INITIALIZER, { 0 }, NULL };
+
+static pthread_once_t sb_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t sb_stats_key;
+
+static void sb_stats_add(SB_BufferStats *dst, SB_BufferStats *src){
+    uint64_t peak = SB_STATS_READ(src->peak_capacity);
+    int k;
+
+    dst->sso_exits += SB_STATS_READ(src->sso_exits);
+    dst->reallocs += SB_STATS_READ(src->reallocs);
+    dst->bytes_copied += SB_STATS_READ(src->bytes_copied);
+    if (peak > dst->peak_capacity) dst->peak_capacity = peak;
+    dst->frees += SB_STATS_READ(src->frees);
+    dst->resets += SB_STATS_READ(src->resets);
+    dst->finalizes += SB_STATS_READ(src->finalizes);
+    dst->copies += SB_STATS_READ(src->copies);
+    dst->copy_bytes += SB_STATS_READ(src->copy_bytes);
+    for (k = 0; k < SB_STATS_BUCKETS; k++) dst->final_size[k] += SB_STATS_READ(src->final_size[k]);
+    dst->final_size_sum += SB_STATS_READ(src->final_size_sum);
+}
+
+static void sb_stats_thread_exit(void *arg){
+    SB_StatsThread *t = (SB_StatsThread*)arg;
+
+    pthread_mutex_lock(&sb_stats_global.lock);
+    sb_stats_add(&sb_stats_global.retired, &t->c);
+    if (t->prev) t->prev->next = t->next;
+    else sb_stats_global.threads = t->next;
+    if (t->next) t->next->prev = t->prev;
+    t->registered = 0;
+    pthread_mutex_unlock(&sb_stats_global.lock);
+}
+
+static void sb_stats_make_key(void){
+    pthread_key_create(&sb_stats_key, sb_stats_thread_exit);
+}
+
+/* Calling thread's counters, registered on first use */
+static SB_BufferStats *sb_stats_local(void){
+    SB_StatsThread *t = &sb_stats_tls;
+
+    if (SB_BUFFER_LIKELY(t->registered)) return &t->c;
+
+    pthread_once(&sb_stats_once, sb_stats_make_key);
+    pthread_setspecific(sb_stats_key, t);
+
+    pthread_mutex_lock(&sb_stats_global.lock);
+    t->prev = NULL;
+    t->next = sb_stats_global.threads;
+    if (t->next) t->next->prev = t;
+    sb_stats_global.threads = t;
+    t->registered = 1;
+    pthread_mutex_unlock(&sb_stats_global.lock);
+    return &t->c;
+}
+
+/* --- Hooks --- */
+
+void sb_stats_on_set_cap(int from_inline, int moved, size_t copied, size_t new_cap){
+    SB_BufferStats *c = sb_stats_local();
+
+    if (from_inline) SB_STATS_ADD(c->sso_exits, 1);
+    else SB_STATS_ADD(c->reallocs, 1);
+    if (moved) SB_STATS_ADD(c->bytes_copied, copied);
+    if (new_cap > c->peak_capacity) __atomic_store_n(&c->peak_capacity, (uint64_t)new_cap, __ATOMIC_RELAXED);
+}
+
+void sb_stats_on_release(int finalize, int freed, size_t len){
+    SB_BufferStats *c = sb_stats_local();
+
+    if (freed) SB_STATS_ADD(c->frees, 1);
+    if (finalize) {
+        int k = 0;
+        while (k < SB_STATS_BUCKETS - 1 && len > ((size_t)16 << k)) k++;
+        SB_STATS_ADD(c->finalizes, 1);
+        SB_STATS_ADD(c->final_size[k], 1);
+        SB_STATS_ADD(c->final_size_sum, len);
+    } else {
+        SB_STATS_ADD(c->resets, 1);
+    }
+}
+
+void sb_stats_on_copy(size_t len){
+    SB_BufferStats *c = sb_stats_local();
+
+    SB_STATS_ADD(c->copies, 1);
+    SB_STATS_ADD(c->copy_bytes, len);
+}
+
+#endif /* SB_BUFFER_STATS */
+
+/* --- Public API --- */
+
+/**
+ * @brief Reads the counters.
+ */
+int sb_buffer_stats_get(SB_BufferStats *stats){
+#if defined(SB_BUFFER_STATS)
+    SB_StatsThread *t;
+#endif
+
+    if (stats == NULL) return 0;
+    memset(stats, 0, sizeof(*stats));
+
+#if defined(SB_BUFFER_STATS)
+    pthread_mutex_lock(&sb_stats_global.lock);
+    sb_stats_add(stats, &sb_stats_global.retired);
+    for (t = sb_stats_global.threads; t; t = t->next) sb_stats_add(stats, &t->c);
+    pthread_mutex_unlock(&sb_stats_global.lock);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Appends the counters in Prometheus text format.
+ */
+int sb_buffer_stats_prometheus(SB_Buffer *out){
+    static const struct { const char *name, *type, *help; size_t offset; } metrics[] = {
+        { "sb_buffer_sso_exits_total", "counter", "Buffers that left their inline storage.", offsetof(SB_BufferStats, sso_exits) },
+        { "sb_buffer_reallocs_total", "counter", "Capacity changes of heap blocks.", offsetof(SB_BufferStats, reallocs) },
+        { "sb_buffer_grow_copied_bytes_total", "counter", "Bytes copied by buffer growth.", offsetof(SB_BufferStats, bytes_copied) },
+        { "sb_buffer_peak_capacity_bytes", "gauge", "Largest capacity of any buffer.", offsetof(SB_BufferStats, peak_capacity) },
+        { "sb_buffer_frees_total", "counter", "Heap blocks released by reset or finalize.", offsetof(SB_BufferStats, frees) },
+        { "sb_buffer_resets_total", "counter", "Calls to sb_buffer_reset.", offsetof(SB_BufferStats, resets) },
+        { "sb_buffer_finalizes_total", "counter", "Calls to sb_buffer_finalize.", offsetof(SB_BufferStats, finalizes) },
+        { "sb_buffer_copies_total", "counter", "Calls to sb_buffer_copy.", offsetof(SB_BufferStats, copies) },
+        { "sb_buffer_copy_bytes_total", "counter", "Bytes copied by sb_buffer_copy.", offsetof(SB_BufferStats, copy_bytes) },
+    };
+    SB_BufferStats st;
+    uint64_t cumulative = 0;
+    size_t i;
+    int ok = 1;
+
+    CHECK_SB_BUFFER_POINTER_RET(out, 0);
+    if (!sb_buffer_stats_get(&st)) return 0;
+
+    for (i = 0; i < sizeof(metrics) / sizeof(metrics[0]); i++) {
+        uint64_t v = *(const uint64_t*)(const void*)((const char*)&st + metrics[i].offset);
+        ok &= sb_buffer_appendf(out, "# HELP %s %s\n# TYPE %s %s\n%s %llu\n",
+                                metrics[i].name, metrics[i].help, metrics[i].name, metrics[i].type,
+                                metrics[i].name, (unsigned long long)v);
+    }
+
+    ok &= sb_buffer_add_literal(out, "# HELP sb_buffer_final_size_bytes Content size of buffers at finalize.\n"
+                                     "# TYPE sb_buffer_final_size_bytes histogram\n");
+    for (i = 0; i < SB_STATS_BUCKETS; i++) {
+        cumulative += st.final_size[i];
+        if (i + 1 < SB_STATS_BUCKETS) {
+            ok &= sb_buffer_appendf(out, "sb_buffer_final_size_bytes_bucket{le=\"%llu\"} %llu\n",
+                                    (unsigned long long)((uint64_t)16 << i), (unsigned long long)cumulative);
+        } else {
+            ok &= sb_buffer_appendf(out, "sb_buffer_final_size_bytes_bucket{le=\"+Inf\"} %llu\n",
+                                    (unsigned long long)cumulative);
+        }
+    }
+    ok &= sb_buffer_appendf(out, "sb_buffer_final_size_bytes_sum %llu\nsb_buffer_final_size_bytes_count %llu\n",
+                            (unsigned long long)st.final_size_sum, (unsigned long long)cumulative);
+    return ok;
+}
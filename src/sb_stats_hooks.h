@@ -0,0 +1,27 @@
+/*
+ * Internal recording hooks of sb_stats.h (not installed).
+ *
+ * Without SB_BUFFER_STATS every hook expands to nothing, so the library
+ * pays nothing for the instrumentation.
+ */
+#ifndef SB_STATS_HOOKS_H
+#define SB_STATS_HOOKS_H
+
+#include <stddef.h>
+
+#if defined(SB_BUFFER_STATS)
+
+void sb_stats_on_set_cap(int from_inline, int moved, size_t copied, size_t new_cap);
+void sb_stats_on_release(int finalize, int freed, size_t len);
+void sb_stats_on_copy(size_t len);
+
+#  define SB_STATS_SET_CAP(from_inline, moved, copied, cap) sb_stats_on_set_cap(from_inline, moved, copied, cap)
+#  define SB_STATS_RELEASE(finalize, freed, len) sb_stats_on_release(finalize, freed, len)
+#  define SB_STATS_COPY(len) sb_stats_on_copy(len)
+#else
+#  define SB_STATS_SET_CAP(from_inline, moved, copied, cap) ((void)0)
+#  define SB_STATS_RELEASE(finalize, freed, len) ((void)0)
+#  define SB_STATS_COPY(len) ((void)0)
+#endif
+
+#endif /* SB_STATS_HOOKS_H */
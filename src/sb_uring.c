@@ -0,0 +1,433 @@
+#define _GNU_SOURCE /* MSG_NOSIGNAL, syscall */
+#include "sb_uring.h"
+#include "sb_iovec.h"
+#include "sb_pool.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    define SB_URING_HAVE_RING 1
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#  endif
+#endif
+
+#define SB_URING_NONE ((unsigned)-1)
+
+enum { SB_SLOT_FREE, SB_SLOT_PENDING, SB_SLOT_ACTIVE };
+
+/* One batch: the moved-in buffers and the write state */
+typedef struct {
+    SB_BufferHeap bufs[SB_URING_MAX_BATCH];
+    SB_Buffer *ptrs[SB_URING_MAX_BATCH];
+    struct iovec iov[SB_URING_MAX_BATCH];
+    struct msghdr msg;
+    SB_IovecCursor cursor;
+    int fd;
+    unsigned flags;
+    unsigned state;
+    unsigned next;  /* Free list link */
+    unsigned seq;   /* Queue order, to keep writes to one fd in order */
+} SB_UringSlot;
+
+#define SB_URING_SLOTS(u) ((SB_UringSlot*)(u)->slots)
+
+/* Scratch array of the kick, allocated right after the slots */
+#define SB_URING_ORDER(u) ((unsigned*)(void*)(SB_URING_SLOTS(u) + (u)->entries))
+
+/* --- Validation and fallback --- */
+
+static int sb_uring_check(SB_Buffer *const *bufs, size_t count){
+    size_t i;
+
+    if (bufs == NULL || count == 0 || count > SB_URING_MAX_BATCH) return 0;
+    for (i = 0; i < count; i++) {
+        if (!sb_buffer_isbuffer(bufs[i])) return 0;
+    }
+    return 1;
+}
+
+/* Synchronous write of a whole batch */
+static int sb_uring_write_sync(SB_Uring *u, int fd, SB_Buffer *const *bufs, size_t count, unsigned flags){
+    SB_IovecCursor c;
+    size_t i;
+
+    sb_iovec_cursor_init(&c, bufs, count);
+    while (!sb_iovec_cursor_done(&c)) {
+        ssize_t n = (flags & SB_URING_SEND) ? sb_iovec_sendmsg(fd, &c, MSG_NOSIGNAL) : sb_iovec_writev(fd, &c);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            u->errors++;
+            u->last_error = errno;
+            return 0;
+        }
+        u->bytes_written += (uint64_t)n;
+    }
+
+    for (i = 0; i < count; i++) sb_buffer_clear(bufs[i]);
+    return 1;
+}
+
+#if defined(SB_URING_HAVE_RING)
+
+/* --- Ring plumbing --- */
+
+static int sb_uring_setup(SB_Uring *u, unsigned entries){
+    struct io_uring_params p;
+    int fd;
+
+    memset(&p, 0, sizeof(p));
+    fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (fd < 0) return 0;
+
+    u->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    u->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (u->cq_ring_size > u->sq_ring_size) u->sq_ring_size = u->cq_ring_size;
+        u->cq_ring_size = u->sq_ring_size;
+    }
+
+    u->sq_ring = mmap(NULL, u->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (u->sq_ring == MAP_FAILED) { close(fd); return 0; }
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        u->cq_ring = u->sq_ring;
+    } else {
+        u->cq_ring = mmap(NULL, u->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (u->cq_ring == MAP_FAILED) { munmap(u->sq_ring, u->sq_ring_size); close(fd); return 0; }
+    }
+
+    u->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes = mmap(NULL, u->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED) {
+        if (u->cq_ring != u->sq_ring) munmap(u->cq_ring, u->cq_ring_size);
+        munmap(u->sq_ring, u->sq_ring_size);
+        close(fd);
+        return 0;
+    }
+
+    u->sq_head = (unsigned*)((char*)u->sq_ring + p.sq_off.head);
+    u->sq_tail = (unsigned*)((char*)u->sq_ring + p.sq_off.tail);
+    u->sq_mask = (unsigned*)((char*)u->sq_ring + p.sq_off.ring_mask);
+    u->sq_array = (unsigned*)((char*)u->sq_ring + p.sq_off.array);
+    u->cq_head = (unsigned*)((char*)u->cq_ring + p.cq_off.head);
+    u->cq_tail = (unsigned*)((char*)u->cq_ring + p.cq_off.tail);
+    u->cq_mask = (unsigned*)((char*)u->cq_ring + p.cq_off.ring_mask);
+    u->cqes = (char*)u->cq_ring + p.cq_off.cqes;
+    u->ring_fd = fd;
+    return 1;
+}
+
+static void sb_uring_teardown(SB_Uring *u){
+    munmap(u->sqes, u->sqes_size);
+    if (u->cq_ring != u->sq_ring) munmap(u->cq_ring, u->cq_ring_size);
+    munmap(u->sq_ring, u->sq_ring_size);
+    close(u->ring_fd);
+    u->ring_fd = -1;
+}
+
+static int sb_uring_enter(SB_Uring *u, unsigned to_submit, unsigned min_complete){
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    int r;
+
+    do {
+        r = (int)syscall(__NR_io_uring_enter, u->ring_fd, to_submit, min_complete, flags, NULL, 0);
+    } while (r < 0 && errno == EINTR);
+
+    if (r < 0) return -1;
+    u->to_submit -= (unsigned)r < u->to_submit ? (unsigned)r : u->to_submit;
+    return r;
+}
+
+/* Queues the SQE writing what is left of slot i (linked to the next SQE if link is set) */
+static void sb_uring_push(SB_Uring *u, unsigned i, int link){
+    SB_UringSlot *s = &SB_URING_SLOTS(u)[i];
+    unsigned tail = *u->sq_tail;
+    unsigned idx = tail & *u->sq_mask;
+    struct io_uring_sqe *sqe = &((struct io_uring_sqe*)u->sqes)[idx];
+    size_t n = sb_iovec_cursor_fill(&s->cursor, s->iov, SB_URING_MAX_BATCH);
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = s->fd;
+    sqe->user_data = i;
+    if (link) sqe->flags = IOSQE_IO_LINK;
+    if (s->flags & SB_URING_SEND) {
+        memset(&s->msg, 0, sizeof(s->msg));
+        s->msg.msg_iov = s->iov;
+        s->msg.msg_iovlen = n;
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->addr = (uint64_t)(uintptr_t)&s->msg;
+        sqe->len = 1;
+        /* WAITALL: a short send fails the link instead of letting the next batch overtake */
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    } else {
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->addr = (uint64_t)(uintptr_t)s->iov;
+        sqe->len = (unsigned)n;
+        sqe->off = (uint64_t)-1; /* Current file position */
+    }
+
+    u->sq_array[idx] = idx;
+    __atomic_store_n(u->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    s->state = SB_SLOT_ACTIVE;
+    u->to_submit++;
+    u->in_flight++;
+}
+
+/* --- Slots --- */
+
+static int sb_uring_fd_busy(SB_Uring *u, int fd){
+    unsigned i;
+
+    for (i = 0; i < u->entries; i++) {
+        if (SB_URING_SLOTS(u)[i].state == SB_SLOT_ACTIVE && SB_URING_SLOTS(u)[i].fd == fd) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Starts the pending batches of every idle fd. The batches of one fd form a
+ * linked chain, executed in queue order; a failed or short write cancels the
+ * rest of the chain, which goes back to pending and is resubmitted behind it.
+ */
+static void sb_uring_kick(SB_Uring *u){
+    SB_UringSlot *slots = SB_URING_SLOTS(u);
+    unsigned *order = SB_URING_ORDER(u);
+    unsigned n = 0, i, j;
+
+    /* Pending slots sorted by queue order (mostly sorted already) */
+    for (i = 0; i < u->entries; i++) {
+        if (slots[i].state != SB_SLOT_PENDING) continue;
+        for (j = n++; j > 0 && (int)(slots[order[j - 1]].seq - slots[i].seq) > 0; j--) order[j] = order[j - 1];
+        order[j] = i;
+    }
+
+    for (i = 0; i < n; i++) {
+        int fd = slots[order[i]].fd;
+        unsigned last = SB_URING_NONE;
+
+        if (slots[order[i]].state != SB_SLOT_PENDING || sb_uring_fd_busy(u, fd)) continue;
+
+        /* The whole chain of fd, linking each SQE to the next one */
+        for (j = i; j < n; j++) {
+            if (slots[order[j]].fd != fd) continue;
+            if (last != SB_URING_NONE) sb_uring_push(u, last, 1);
+            slots[order[j]].state = SB_SLOT_ACTIVE;
+            last = order[j];
+        }
+        sb_uring_push(u, last, 0);
+    }
+}
+
+/* Gives the storage back to the pool */
+static void sb_uring_finish(SB_Uring *u, unsigned i){
+    SB_UringSlot *s = &SB_URING_SLOTS(u)[i];
+    size_t k;
+
+    for (k = 0; k < s->cursor.count; k++) sb_buffer_pool_release(s->ptrs[k]);
+
+    s->state = SB_SLOT_FREE;
+    s->next = u->free_slot;
+    u->free_slot = i;
+}
+
+/* Submits what is queued and processes the completions; waits for one if wait is set */
+static int sb_uring_reap(SB_Uring *u, int wait){
+    unsigned head;
+
+    sb_uring_kick(u);
+    if (wait && *u->cq_head == __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE)) {
+        if (sb_uring_enter(u, u->to_submit, 1) < 0) return 0;
+    } else if (u->to_submit && sb_uring_enter(u, u->to_submit, 0) < 0) {
+        return 0;
+    }
+
+    head = *u->cq_head;
+    while (head != __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *cqe = &((struct io_uring_cqe*)u->cqes)[head & *u->cq_mask];
+        unsigned i = (unsigned)cqe->user_data;
+        int res = cqe->res;
+        SB_UringSlot *s = &SB_URING_SLOTS(u)[i];
+
+        head++;
+        __atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+        u->in_flight--;
+
+        if (res == -ECANCELED || res == -EINTR || res == -EAGAIN) {
+            /* Retried in order by the next kick */
+            s->state = SB_SLOT_PENDING;
+        } else if (res < 0 || (res == 0 && !sb_iovec_cursor_done(&s->cursor))) {
+            u->errors++;
+            u->last_error = res < 0 ? -res : EIO;
+            sb_uring_finish(u, i);
+        } else {
+            u->bytes_written += (uint64_t)res;
+            /* Short write: the rest is resubmitted by the next kick */
+            if (sb_iovec_cursor_advance(&s->cursor, (size_t)res)) sb_uring_finish(u, i);
+            else s->state = SB_SLOT_PENDING;
+        }
+    }
+    return 1;
+}
+
+#endif /* SB_URING_HAVE_RING */
+
+/* --- Public API --- */
+
+/**
+ * @brief Creates the ring (or selects the synchronous fallback).
+ */
+int sb_uring_init(SB_Uring *u, unsigned entries){
+    SB_UringSlot *slots;
+    unsigned i, k;
+
+    if (u == NULL || entries == 0 || entries > 4096) return 0;
+
+    memset(u, 0, sizeof(*u));
+    u->ring_fd = -1;
+
+    /* Round up to a power of two, as the kernel does */
+    for (k = 1; k < entries; k <<= 1) { }
+    entries = k;
+
+    slots = (SB_UringSlot*)malloc(entries * (sizeof(SB_UringSlot) + sizeof(unsigned)));
+    if (!slots) return 0;
+
+    for (i = 0; i < entries; i++) {
+        for (k = 0; k < SB_URING_MAX_BATCH; k++) {
+            SB_BUFFER_INIT_SIZED(&slots[i].bufs[k]);
+            slots[i].ptrs[k] = SB_BUFFER_AS(&slots[i].bufs[k]);
+        }
+        slots[i].state = SB_SLOT_FREE;
+        slots[i].next = i + 1 < entries ? i + 1 : SB_URING_NONE;
+    }
+    u->slots = slots;
+    u->entries = entries;
+    u->free_slot = 0;
+
+#if defined(SB_URING_HAVE_RING)
+    if (!getenv("SB_URING_DISABLE")) sb_uring_setup(u, entries);
+#endif
+    return 1;
+}
+
+/**
+ * @brief Returns 1 if the writer uses io_uring.
+ */
+int sb_uring_is_async(const SB_Uring *u){
+    return u != NULL && u->ring_fd >= 0;
+}
+
+/**
+ * @brief Takes ownership of count buffers and queues them as one write.
+ */
+int sb_uring_queue(SB_Uring *u, int fd, SB_Buffer *const *bufs, size_t count, unsigned flags){
+    SB_UringSlot *s;
+    unsigned i;
+    size_t k;
+
+    if (u == NULL || u->slots == NULL || fd < 0 || !sb_uring_check(bufs, count)) return 0;
+
+    if (u->ring_fd < 0) return sb_uring_write_sync(u, fd, bufs, count, flags);
+
+#if defined(SB_URING_HAVE_RING)
+    /* All slots busy: wait for a completion */
+    while (u->free_slot == SB_URING_NONE) {
+        if (!sb_uring_reap(u, 1)) return 0;
+    }
+
+    i = u->free_slot;
+    s = &SB_URING_SLOTS(u)[i];
+    u->free_slot = s->next;
+
+    s->fd = fd;
+    s->flags = flags;
+    s->seq = u->seq++;
+    s->state = SB_SLOT_PENDING;
+    sb_iovec_cursor_init(&s->cursor, s->ptrs, count);
+
+    /* Take the storage: heap blocks are stolen, inline content goes to a pooled block */
+    for (k = 0; k < count; k++) {
+        if (bufs[k]->str == bufs[k]->init && bufs[k]->len) sb_buffer_pool_acquire(s->ptrs[k], bufs[k]->len);
+        if (!sb_buffer_move(bufs[k], s->ptrs[k])) {
+            /* Out of memory: the batch is dropped */
+            u->errors++;
+            u->last_error = ENOMEM;
+            sb_uring_finish(u, i);
+            return 0;
+        }
+    }
+
+    /* Started by the next submit, behind the batches already queued for fd */
+    if (sb_iovec_cursor_done(&s->cursor)) sb_uring_finish(u, i);
+    return 1;
+#else
+    (void)s; (void)i; (void)k;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Submits every queued batch and reaps available completions.
+ */
+int sb_uring_submit(SB_Uring *u){
+    if (u == NULL) return 0;
+    if (u->ring_fd < 0) return 1;
+
+#if defined(SB_URING_HAVE_RING)
+    return sb_uring_reap(u, 0);
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Submits and waits until every batch has completed.
+ */
+int sb_uring_flush(SB_Uring *u){
+    unsigned i;
+
+    if (u == NULL || u->slots == NULL) return 0;
+
+#if defined(SB_URING_HAVE_RING)
+    while (u->ring_fd >= 0) {
+        int busy = 0;
+        for (i = 0; i < u->entries; i++) {
+            if (SB_URING_SLOTS(u)[i].state != SB_SLOT_FREE) { busy = 1; break; }
+        }
+        if (!busy) break;
+        if (!sb_uring_reap(u, 1)) return 0;
+    }
+#else
+    (void)i;
+#endif
+    i = u->errors == u->errors_reported;
+    u->errors_reported = u->errors;
+    return (int)i;
+}
+
+/**
+ * @brief Flushes, then releases the ring and the slots.
+ */
+int sb_uring_finalize(SB_Uring *u){
+    unsigned i, k;
+    int ok;
+
+    if (u == NULL || u->slots == NULL) return 0;
+
+    ok = sb_uring_flush(u);
+#if defined(SB_URING_HAVE_RING)
+    if (u->ring_fd >= 0) sb_uring_teardown(u);
+#endif
+    for (i = 0; i < u->entries; i++) {
+        for (k = 0; k < SB_URING_MAX_BATCH; k++) sb_buffer_finalize(SB_URING_SLOTS(u)[i].ptrs[k]);
+    }
+    free(u->slots);
+    u->slots = NULL;
+    return ok;
+}
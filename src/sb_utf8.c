@@ -0,0 +1,364 @@
+#include "sb_utf8.h"
+#include "sb_simd.h"
+#include <string.h>
+
+/* --- Scalar kernels --- */
+
+/* Validates in[0, n) byte by byte, skipping 8 ASCII bytes at a time */
+static int sb_utf8_valid_scalar(const unsigned char *in, size_t n){
+    size_t i = 0;
+
+    while (i < n) {
+        unsigned c = in[i], c1;
+        uint64_t w;
+
+        if (c < 0x80) {
+            if (i + 8 <= n) {
+                memcpy(&w, in + i, 8);
+                if (!(w & 0x8080808080808080ull)) { i += 8; continue; }
+            }
+            i++;
+            continue;
+        }
+        if (c < 0xC2) return 0; /* Stray continuation, or overlong 2-byte form */
+        if (c < 0xE0) {
+            if (i + 1 >= n || (in[i + 1] & 0xC0) != 0x80) return 0;
+            i += 2;
+            continue;
+        }
+        if (c < 0xF0) {
+            if (i + 2 >= n) return 0;
+            c1 = in[i + 1];
+            if ((c1 & 0xC0) != 0x80 || (in[i + 2] & 0xC0) != 0x80) return 0;
+            if ((c == 0xE0 && c1 < 0xA0) || (c == 0xED && c1 >= 0xA0)) return 0; /* Overlong, surrogate */
+            i += 3;
+            continue;
+        }
+        if (c < 0xF5) {
+            if (i + 3 >= n) return 0;
+            c1 = in[i + 1];
+            if ((c1 & 0xC0) != 0x80 || (in[i + 2] & 0xC0) != 0x80 || (in[i + 3] & 0xC0) != 0x80) return 0;
+            if ((c == 0xF0 && c1 < 0x90) || (c == 0xF4 && c1 >= 0x90)) return 0; /* Overlong, > U+10FFFF */
+            i += 4;
+            continue;
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/* Transcodes in[0, n) up to (not including) stop, or one pair past it.
+   Returns the new output position, or (size_t)-1 on an unpaired surrogate. */
+static size_t sb_utf16_scalar(unsigned char *out, size_t o, const uint16_t *in, size_t *pi, size_t stop, size_t n){
+    size_t i = *pi;
+
+    while (i < stop) {
+        uint32_t c = in[i++];
+
+        if (c < 0x80) {
+            out[o++] = (unsigned char)c;
+        } else if (c < 0x800) {
+            out[o++] = (unsigned char)(0xC0 | (c >> 6));
+            out[o++] = (unsigned char)(0x80 | (c & 0x3F));
+        } else if (c - 0xD800 >= 0x800) {
+            out[o++] = (unsigned char)(0xE0 | (c >> 12));
+            out[o++] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+            out[o++] = (unsigned char)(0x80 | (c & 0x3F));
+        } else {
+            if (c >= 0xDC00 || i >= n || (uint32_t)(in[i] - 0xDC00) >= 0x400) return (size_t)-1;
+            c = 0x10000 + ((c - 0xD800) << 10) + (uint32_t)(in[i++] - 0xDC00);
+            out[o++] = (unsigned char)(0xF0 | (c >> 18));
+            out[o++] = (unsigned char)(0x80 | ((c >> 12) & 0x3F));
+            out[o++] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+            out[o++] = (unsigned char)(0x80 | (c & 0x3F));
+        }
+    }
+    *pi = i;
+    return o;
+}
+
+/* --- Vector validation ---
+ *
+ * Lookup algorithm of Keiser and Lemire ("Validating UTF-8 in less than one
+ * instruction per byte", 2021). Every error shows in the pair formed by a
+ * byte and the one before it: three 16-entry tables, indexed by the high and
+ * low nibble of the previous byte and the high nibble of the current one,
+ * each give the error classes that nibble allows, and their AND is non-zero
+ * only for an invalid pair. A continuation that must be the 2nd or 3rd of a
+ * 3/4-byte sequence is then matched against the lead two or three bytes
+ * back. A block ending in an unfinished sequence is checked against the next.
+ */
+
+#define SB_U8_TOO_SHORT  0x01 /* Lead or ASCII followed by a lead */
+#define SB_U8_TOO_LONG   0x02 /* ASCII followed by a continuation */
+#define SB_U8_OVERLONG_3 0x04
+#define SB_U8_TOO_LARGE  0x08
+#define SB_U8_SURROGATE  0x10
+#define SB_U8_OVERLONG_2 0x20
+#define SB_U8_TOO_LARGE_1000 0x40
+#define SB_U8_OVERLONG_4 0x40
+#define SB_U8_TWO_CONTS  0x80 /* Continuation after a continuation (valid only as byte 3 or 4) */
+#define SB_U8_CARRY (SB_U8_TOO_SHORT | SB_U8_TOO_LONG | SB_U8_TWO_CONTS)
+
+#if defined(SB_SIMD_AVX2) || defined(SB_SIMD_NEON)
+
+/* Indexed by the high nibble of the previous byte */
+static const unsigned char sb_u8_prev_high[16] = {
+    SB_U8_TOO_LONG, SB_U8_TOO_LONG, SB_U8_TOO_LONG, SB_U8_TOO_LONG,
+    SB_U8_TOO_LONG, SB_U8_TOO_LONG, SB_U8_TOO_LONG, SB_U8_TOO_LONG,
+    SB_U8_TWO_CONTS, SB_U8_TWO_CONTS, SB_U8_TWO_CONTS, SB_U8_TWO_CONTS,
+    SB_U8_TOO_SHORT | SB_U8_OVERLONG_2,
+    SB_U8_TOO_SHORT,
+    SB_U8_TOO_SHORT | SB_U8_OVERLONG_3 | SB_U8_SURROGATE,
+    SB_U8_TOO_SHORT | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000 | SB_U8_OVERLONG_4
+};
+
+/* Indexed by the low nibble of the previous byte */
+static const unsigned char sb_u8_prev_low[16] = {
+    SB_U8_CARRY | SB_U8_OVERLONG_3 | SB_U8_OVERLONG_2 | SB_U8_OVERLONG_4,
+    SB_U8_CARRY | SB_U8_OVERLONG_2,
+    SB_U8_CARRY,
+    SB_U8_CARRY,
+    SB_U8_CARRY | SB_U8_TOO_LARGE,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000 | SB_U8_SURROGATE,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000,
+    SB_U8_CARRY | SB_U8_TOO_LARGE | SB_U8_TOO_LARGE_1000
+};
+
+/* Indexed by the high nibble of the current byte */
+static const unsigned char sb_u8_cur_high[16] = {
+    SB_U8_TOO_SHORT, SB_U8_TOO_SHORT, SB_U8_TOO_SHORT, SB_U8_TOO_SHORT,
+    SB_U8_TOO_SHORT, SB_U8_TOO_SHORT, SB_U8_TOO_SHORT, SB_U8_TOO_SHORT,
+    SB_U8_TOO_LONG | SB_U8_OVERLONG_2 | SB_U8_TWO_CONTS | SB_U8_OVERLONG_3 | SB_U8_TOO_LARGE_1000 | SB_U8_OVERLONG_4,
+    SB_U8_TOO_LONG | SB_U8_OVERLONG_2 | SB_U8_TWO_CONTS | SB_U8_OVERLONG_3 | SB_U8_TOO_LARGE,
+    SB_U8_TOO_LONG | SB_U8_OVERLONG_2 | SB_U8_TWO_CONTS | SB_U8_SURROGATE | SB_U8_TOO_LARGE,
+    SB_U8_TOO_LONG | SB_U8_OVERLONG_2 | SB_U8_TWO_CONTS | SB_U8_SURROGATE | SB_U8_TOO_LARGE,
+    SB_U8_TOO_SHORT, SB_U8_TOO_SHORT, SB_U8_TOO_SHORT, SB_U8_TOO_SHORT
+};
+
+/* Last byte values of a block that do not leave a sequence open: 0xFF except
+   a 4-byte lead in the last 3, 3-byte in the last 2, 2-byte in the last one */
+static const unsigned char sb_u8_max_tail[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+#endif
+
+#if defined(SB_SIMD_AVX2)
+
+/* Error bits of block x, prev being the block before it */
+SB_TARGET_SSSE3 static inline __m128i sb_utf8_block_ssse3(__m128i x, __m128i prev,
+                                                          __m128i t_prev_high, __m128i t_prev_low, __m128i t_cur_high){
+    const __m128i nib = _mm_set1_epi8(0x0F);
+    __m128i prev1 = _mm_alignr_epi8(x, prev, 15);
+    __m128i prev2 = _mm_alignr_epi8(x, prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(x, prev, 13);
+    __m128i sc = _mm_and_si128(
+        _mm_and_si128(_mm_shuffle_epi8(t_prev_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nib)),
+                      _mm_shuffle_epi8(t_prev_low, _mm_and_si128(prev1, nib))),
+        _mm_shuffle_epi8(t_cur_high, _mm_and_si128(_mm_srli_epi16(x, 4), nib)));
+    /* Only 111xxxxx two bytes back, or 1111xxxx three back, reach 0x80 */
+    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must23, sc);
+}
+
+/* Validates in[0, n), copying it to out on the way unless out is NULL */
+SB_TARGET_SSSE3 static int sb_utf8_valid_ssse3(unsigned char *out, const unsigned char *in, size_t n){
+    const __m128i t_prev_high = _mm_loadu_si128((const __m128i*)sb_u8_prev_high);
+    const __m128i t_prev_low = _mm_loadu_si128((const __m128i*)sb_u8_prev_low);
+    const __m128i t_cur_high = _mm_loadu_si128((const __m128i*)sb_u8_cur_high);
+    const __m128i max_tail = _mm_loadu_si128((const __m128i*)sb_u8_max_tail);
+    __m128i prev = _mm_setzero_si128(), incomplete = _mm_setzero_si128(), error = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+        if (out) _mm_storeu_si128((__m128i*)(out + i), x);
+        if (_mm_movemask_epi8(x) == 0) {
+            /* ASCII: only a sequence left open by the previous block can fail */
+            error = _mm_or_si128(error, incomplete);
+            incomplete = _mm_setzero_si128();
+        } else {
+            error = _mm_or_si128(error, sb_utf8_block_ssse3(x, prev, t_prev_high, t_prev_low, t_cur_high));
+            incomplete = _mm_subs_epu8(x, max_tail);
+        }
+        prev = x;
+    }
+
+    if (i < n) {
+        /* Zero padding fails any sequence the input leaves open */
+        unsigned char tail[16] = {0};
+        memcpy(tail, in + i, n - i);
+        if (out) memcpy(out + i, in + i, n - i);
+        error = _mm_or_si128(error, sb_utf8_block_ssse3(_mm_loadu_si128((const __m128i*)tail), prev,
+                                                        t_prev_high, t_prev_low, t_cur_high));
+    } else {
+        error = _mm_or_si128(error, incomplete);
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+#elif defined(SB_SIMD_NEON)
+
+static inline uint8x16_t sb_utf8_block_neon(uint8x16_t x, uint8x16_t prev,
+                                             uint8x16_t t_prev_high, uint8x16_t t_prev_low, uint8x16_t t_cur_high){
+    uint8x16_t prev1 = vextq_u8(prev, x, 15);
+    uint8x16_t prev2 = vextq_u8(prev, x, 14);
+    uint8x16_t prev3 = vextq_u8(prev, x, 13);
+    uint8x16_t sc = vandq_u8(vandq_u8(vqtbl1q_u8(t_prev_high, vshrq_n_u8(prev1, 4)),
+                                      vqtbl1q_u8(t_prev_low, vandq_u8(prev1, vdupq_n_u8(0x0F)))),
+                             vqtbl1q_u8(t_cur_high, vshrq_n_u8(x, 4)));
+    uint8x16_t third = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+    uint8x16_t fourth = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+    uint8x16_t must23 = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+    return veorq_u8(must23, sc);
+}
+
+static int sb_utf8_valid_neon(unsigned char *out, const unsigned char *in, size_t n){
+    const uint8x16_t t_prev_high = vld1q_u8(sb_u8_prev_high);
+    const uint8x16_t t_prev_low = vld1q_u8(sb_u8_prev_low);
+    const uint8x16_t t_cur_high = vld1q_u8(sb_u8_cur_high);
+    const uint8x16_t max_tail = vld1q_u8(sb_u8_max_tail);
+    uint8x16_t prev = vdupq_n_u8(0), incomplete = vdupq_n_u8(0), error = vdupq_n_u8(0);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t x = vld1q_u8(in + i);
+        if (out) vst1q_u8(out + i, x);
+        if (vmaxvq_u8(x) < 0x80) {
+            error = vorrq_u8(error, incomplete);
+            incomplete = vdupq_n_u8(0);
+        } else {
+            error = vorrq_u8(error, sb_utf8_block_neon(x, prev, t_prev_high, t_prev_low, t_cur_high));
+            incomplete = vqsubq_u8(x, max_tail);
+        }
+        prev = x;
+    }
+
+    if (i < n) {
+        unsigned char tail[16] = {0};
+        memcpy(tail, in + i, n - i);
+        if (out) memcpy(out + i, in + i, n - i);
+        error = vorrq_u8(error, sb_utf8_block_neon(vld1q_u8(tail), prev, t_prev_high, t_prev_low, t_cur_high));
+    } else {
+        error = vorrq_u8(error, incomplete);
+    }
+    return vmaxvq_u8(error) == 0;
+}
+
+#endif
+
+/* Validates in[0, n) and copies it to out (which may be NULL) */
+static int sb_utf8_check(unsigned char *out, const unsigned char *in, size_t n){
+#if defined(SB_SIMD_AVX2)
+    if (n >= 16 && sb_simd_has_ssse3()) return sb_utf8_valid_ssse3(out, in, n);
+#elif defined(SB_SIMD_NEON)
+    if (n >= 16) return sb_utf8_valid_neon(out, in, n);
+#endif
+    if (!sb_utf8_valid_scalar(in, n)) return 0;
+    if (out && n) memcpy(out, in, n);
+    return 1;
+}
+
+/* --- Vector transcoding --- */
+
+/* Transcodes in[0, n) into out, returning the number of bytes written or
+   (size_t)-1 on an unpaired surrogate */
+static size_t sb_utf16_to_utf8(unsigned char *out, const uint16_t *in, size_t n){
+    size_t i = 0, o = 0;
+
+#if defined(SB_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i not_ascii = _mm_set1_epi16((short)0xFF80);
+    const __m128i not_2byte = _mm_set1_epi16((short)0xF800);
+
+    while (i + 8 <= n) {
+        __m128i u = _mm_loadu_si128((const __m128i*)(in + i));
+        int ascii = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(u, not_ascii), zero));
+
+        if (ascii == 0xFFFF) {
+            _mm_storel_epi64((__m128i*)(out + o), _mm_packus_epi16(u, u));
+            i += 8;
+            o += 8;
+            continue;
+        }
+        if (ascii == 0 && _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(u, not_2byte), zero)) == 0xFFFF) {
+            /* U+0080..U+07FF: 110xxxxx 10xxxxxx per unit, lead in the low byte */
+            __m128i lead = _mm_or_si128(_mm_srli_epi16(u, 6), _mm_set1_epi16(0xC0));
+            __m128i cont = _mm_or_si128(_mm_and_si128(u, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+            _mm_storeu_si128((__m128i*)(out + o), _mm_or_si128(lead, _mm_slli_epi16(cont, 8)));
+            i += 8;
+            o += 16;
+            continue;
+        }
+        /* Mixed block: this one unit by unit (a pair may end past it) */
+        o = sb_utf16_scalar(out, o, in, &i, i + 8, n);
+        if (o == (size_t)-1) return o;
+    }
+#endif
+
+    return sb_utf16_scalar(out, o, in, &i, n, n);
+}
+
+/* --- Public API --- */
+
+/**
+ * @brief Checks that s[0, len) is well-formed UTF-8.
+ */
+int sb_utf8_valid(const char *s, size_t len){
+    if (s == NULL) return len == 0;
+    return sb_utf8_check(NULL, (const unsigned char*)s, len);
+}
+
+/**
+ * @brief Appends s[0, len) to the buffer if it is well-formed UTF-8.
+ */
+int sb_buffer_add_utf8_validated(SB_Buffer *b, const char *s, size_t len){
+    char *out;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (s == NULL && len) return 0;
+    if (len == 0) return 1;
+
+    out = sb_buffer_prepare(b, len);
+    if (!out) return 0;
+    if (!sb_utf8_check((unsigned char*)out, (const unsigned char*)s, len)) {
+        SB_BUFFER_TERMINATE(b);
+        return 0;
+    }
+    return sb_buffer_commit(b, len);
+}
+
+/**
+ * @brief Appends UTF-16 code units transcoded to UTF-8.
+ */
+int sb_buffer_add_utf16_as_utf8(SB_Buffer *b, const uint16_t *units, size_t count){
+    char *out;
+    size_t n;
+
+    CHECK_SB_BUFFER_POINTER_RET(b, 0);
+    if (units == NULL && count) return 0;
+    if (count == 0) return 1;
+    if (count > (size_t)-1 / 6) return 0;
+
+    /* 3 bytes per unit bounds every case (a 4-byte sequence takes 2 units) */
+    out = sb_buffer_prepare(b, count * 3);
+    if (!out) return 0;
+    n = sb_utf16_to_utf8((unsigned char*)out, units, count);
+    if (n == (size_t)-1) {
+        SB_BUFFER_TERMINATE(b);
+        return 0;
+    }
+    return sb_buffer_commit(b, n);
+}